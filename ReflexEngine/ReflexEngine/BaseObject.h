@@ -15,6 +15,8 @@ namespace Reflex
 	{
 		Deleted,
 		ConstructionComplete,
+		// Created / destroyed in bulk, systems are updated for the whole batch at once instead of per component
+		DeferSystemMembership,
 		NumFlags,
 	};
 
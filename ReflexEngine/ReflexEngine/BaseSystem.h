@@ -5,6 +5,29 @@ namespace Reflex { class Object; }
 
 namespace Reflex::Systems
 {
+	// Stages of the world update pipeline, stages always run in this order
+	// The Box2D step runs at the start of the Physics stage, systems within a stage are updated by ascending order (ties keep the order they were added)
+	enum class SystemStage
+	{
+		PrePhysics,
+		Physics,
+		PostPhysics,
+		RenderPrep,
+		NumStages,
+	};
+
+	inline const char* GetSystemStageName( const SystemStage stage )
+	{
+		switch( stage )
+		{
+		case SystemStage::PrePhysics: return "PrePhysics";
+		case SystemStage::Physics: return "Physics";
+		case SystemStage::PostPhysics: return "PostPhysics";
+		case SystemStage::RenderPrep: return "RenderPrep";
+		default: return "Unknown";
+		}
+	}
+
 	// Abstract class for internal use. Custom systems should inherit from System
 	class BaseSystem : private sf::NonCopyable, public sf::Drawable
 	{
@@ -17,6 +40,21 @@ namespace Reflex::Systems
 		Reflex::Core::World& GetWorld() { return m_world; }
 		const Reflex::Core::World& GetWorld() const { return m_world; }
 		ComponentsMask GetRequiredComponents() const { return m_requiredComponents; }
+		SystemStage GetStage() const { return m_stage; }
+		int GetOrder() const { return m_order; }
+		ComponentsMask GetReadComponents() const { return m_readComponents; }
+		ComponentsMask GetWriteComponents() const { return m_writeComponents; }
+
+		// Systems that declare their component access (ReadsComponent / WritesComponent) can be updated concurrently with other systems they don't conflict with
+		// Systems that don't declare anything are assumed to touch everything and are always updated on their own
+		bool HasDeclaredAccess() const { return m_declaredAccess; }
+		bool ConflictsWith( const BaseSystem& other ) const
+		{
+			if( !m_declaredAccess || !other.m_declaredAccess )
+				return true;
+
+			return ( m_writeComponents & ( other.m_readComponents | other.m_writeComponents ) ).any() || ( other.m_writeComponents & m_readComponents ).any();
+		}
 
 	protected:
 		virtual void RegisterComponents() = 0;
@@ -38,6 +76,13 @@ namespace Reflex::Systems
 
 	protected:
 		ComponentsMask m_requiredComponents;
+		ComponentsMask m_readComponents;
+		ComponentsMask m_writeComponents;
+		bool m_declaredAccess = false;
+
+		// Set by World::AddSystem
+		SystemStage m_stage = SystemStage::PrePhysics;
+		int m_order = 0;
 
 	private:
 		Reflex::Core::World& m_world;
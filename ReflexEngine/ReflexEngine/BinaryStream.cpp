@@ -0,0 +1,161 @@
+#include "Precompiled.h"
+#include "BinaryStream.h"
+#include "Logging.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Reflex::Core
+{
+	MappedFile::MappedFile( const std::string& file )
+	{
+#ifdef _WIN32
+		m_file = CreateFileA( file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+
+		if( m_file == INVALID_HANDLE_VALUE )
+			THROW( "Failed to open file: " << file );
+
+		LARGE_INTEGER size;
+		GetFileSizeEx( m_file, &size );
+		m_size = ( std::size_t )size.QuadPart;
+
+		// Empty files can't be mapped
+		if( m_size == 0 )
+			return;
+
+		m_mapping = CreateFileMappingA( m_file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+
+		if( m_mapping )
+			m_data = static_cast< const char* >( MapViewOfFile( m_mapping, FILE_MAP_READ, 0, 0, 0 ) );
+#else
+		const auto descriptor = open( file.c_str(), O_RDONLY );
+
+		if( descriptor == -1 )
+			THROW( "Failed to open file: " << file );
+
+		struct stat info;
+		fstat( descriptor, &info );
+		m_size = ( std::size_t )info.st_size;
+
+		if( m_size > 0 )
+		{
+			auto* data = mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0 );
+			m_data = data == MAP_FAILED ? nullptr : static_cast< const char* >( data );
+		}
+
+		close( descriptor );
+#endif
+
+		if( m_size > 0 && !m_data )
+		{
+			Close();
+			THROW( "Failed to map file: " << file );
+		}
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	void MappedFile::Close()
+	{
+#ifdef _WIN32
+		if( m_data )
+			UnmapViewOfFile( m_data );
+		if( m_mapping )
+			CloseHandle( m_mapping );
+		if( m_file != INVALID_HANDLE_VALUE )
+			CloseHandle( m_file );
+
+		m_mapping = nullptr;
+		m_file = INVALID_HANDLE_VALUE;
+#else
+		if( m_data )
+			munmap( const_cast< char* >( m_data ), m_size );
+#endif
+
+		m_data = nullptr;
+	}
+
+	BinaryReader::BinaryReader( const MappedFile& file, const std::string& name )
+		: m_data( file.GetData() )
+		, m_size( file.GetSize() )
+		, m_name( name )
+	{
+	}
+
+	std::string BinaryReader::ReadString()
+	{
+		const auto length = ReadUInt();
+		return std::string( Read( length ), length );
+	}
+
+	FieldValue BinaryReader::ReadFieldValue( const FieldType type )
+	{
+		switch( type )
+		{
+		case FieldType::Bool: return ReadValue< std::uint8_t >() != 0;
+		case FieldType::Int: return ReadValue< int >();
+		case FieldType::Unsigned: return ReadValue< unsigned >();
+		case FieldType::Float: return ReadValue< float >();
+		case FieldType::Vector2f: return ReadValue< sf::Vector2f >();
+		case FieldType::Vector2u: return ReadValue< sf::Vector2u >();
+		case FieldType::Colour: return ReadValue< sf::Color >();
+		case FieldType::String: return ReadString();
+		case FieldType::Points:
+		{
+			const auto count = ReadUInt();
+			return ReadVector< sf::Vector2f >( count );
+		}
+		default: THROW( "Invalid field type in file: " << m_name << ", type: " << ( int )type );
+		}
+	}
+
+	const char* BinaryReader::Read( const std::size_t size )
+	{
+		if( size > m_size - m_position )
+			THROW( "Truncated file: " << m_name );
+
+		const auto* result = m_data + m_position;
+		m_position += size;
+		return result;
+	}
+
+	BinaryWriter::BinaryWriter( const std::string& file )
+		: m_output( file, std::ios::binary )
+	{
+		if( m_output.fail() )
+			THROW( "Failed to open file for writing: " << file );
+	}
+
+	void BinaryWriter::WriteString( const std::string& value )
+	{
+		WriteUInt( ( std::uint32_t )value.size() );
+		m_output.write( value.data(), value.size() );
+	}
+
+	void BinaryWriter::WriteFieldValue( const FieldValue& value )
+	{
+		std::visit( [&]( const auto& typedValue )
+		{
+			typedef std::decay_t< decltype( typedValue ) > Type;
+
+			if constexpr( std::is_same_v< Type, bool > )
+				WriteValue( ( std::uint8_t )typedValue );
+			else if constexpr( std::is_same_v< Type, std::string > )
+				WriteString( typedValue );
+			else if constexpr( std::is_same_v< Type, std::vector< sf::Vector2f > > )
+			{
+				WriteUInt( ( std::uint32_t )typedValue.size() );
+				WriteArray( typedValue.data(), typedValue.size() );
+			}
+			else
+				WriteValue( typedValue );
+		}, value );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Reflection.h"
+
+namespace Reflex::Core
+{
+	// Read only memory mapping of a whole file, the file's pages are loaded by the OS as they are read instead of copied up front
+	class MappedFile : private sf::NonCopyable
+	{
+	public:
+		explicit MappedFile( const std::string& file );
+		~MappedFile();
+
+		const char* GetData() const { return m_data; }
+		std::size_t GetSize() const { return m_size; }
+
+	private:
+		void Close();
+
+		const char* m_data = nullptr;
+		std::size_t m_size = 0U;
+#ifdef _WIN32
+		HANDLE m_file = INVALID_HANDLE_VALUE;
+		HANDLE m_mapping = nullptr;
+#endif
+	};
+
+	// Reads values from a mapped file, running past the end throws (name is used in the error)
+	class BinaryReader
+	{
+	public:
+		BinaryReader( const MappedFile& file, const std::string& name );
+
+		template< typename T >
+		T ReadValue();
+
+		// Copies count values straight from the file
+		template< typename T >
+		std::vector< T > ReadVector( const std::size_t count );
+
+		std::uint32_t ReadUInt() { return ReadValue< std::uint32_t >(); }
+		std::string ReadString();
+		FieldValue ReadFieldValue( const FieldType type );
+
+		bool IsAtEnd() const { return m_position == m_size; }
+		const std::string& GetName() const { return m_name; }
+
+	protected:
+		const char* Read( const std::size_t size );
+
+	private:
+		const char* m_data = nullptr;
+		std::size_t m_size = 0U;
+		std::size_t m_position = 0U;
+		std::string m_name;
+	};
+
+	// Writes values in the layout BinaryReader reads (strings are a 32 bit length followed by the characters)
+	class BinaryWriter
+	{
+	public:
+		BinaryWriter( const std::string& file );
+
+		template< typename T >
+		void WriteValue( const T& value );
+
+		template< typename T >
+		void WriteArray( const T* values, const std::size_t count );
+
+		void WriteUInt( const std::uint32_t value ) { WriteValue( value ); }
+		void WriteString( const std::string& value );
+		void WriteFieldValue( const FieldValue& value );
+
+	private:
+		std::ofstream m_output;
+	};
+
+	// Template definitions
+	template< typename T >
+	T BinaryReader::ReadValue()
+	{
+		static_assert( std::is_trivially_copyable_v< T > );
+		T value;
+		std::memcpy( &value, Read( sizeof( value ) ), sizeof( value ) );
+		return value;
+	}
+
+	template< typename T >
+	std::vector< T > BinaryReader::ReadVector( const std::size_t count )
+	{
+		static_assert( std::is_trivially_copyable_v< T > );
+
+		// Read first so a corrupt count throws instead of allocating
+		const auto* data = Read( sizeof( T ) * count );
+		std::vector< T > values( count );
+		if( count > 0 )
+			std::memcpy( values.data(), data, sizeof( T ) * count );
+		return values;
+	}
+
+	template< typename T >
+	void BinaryWriter::WriteValue( const T& value )
+	{
+		static_assert( std::is_trivially_copyable_v< T > );
+		m_output.write( reinterpret_cast< const char* >( &value ), sizeof( value ) );
+	}
+
+	template< typename T >
+	void BinaryWriter::WriteArray( const T* values, const std::size_t count )
+	{
+		static_assert( std::is_trivially_copyable_v< T > );
+		m_output.write( reinterpret_cast< const char* >( values ), sizeof( T ) * count );
+	}
+}
\ No newline at end of file
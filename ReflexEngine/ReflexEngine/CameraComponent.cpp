@@ -30,72 +30,25 @@ namespace Reflex::Components
 	{
 	}
 
-	namespace
+	Reflex::Core::FieldTable Camera::GetFields()
 	{
-		std::string flagNames[] =
+		static constexpr Reflex::Core::Field fields[] =
 		{
-			"MousePanning",
-			"WASDPanning",
-			"ArrowPanning",
-			"MouseZooming",
-			"ZoomCentreOnMouse",
-			"AdditivePanning",
-			"NormaliseDiagonalPanning",
-			"StartActivated",
+			ReflectFlag( Camera, "MousePanning", flags, MousePanning ),
+			ReflectFlag( Camera, "WASDPanning", flags, WASDPanning ),
+			ReflectFlag( Camera, "ArrowPanning", flags, ArrowPanning ),
+			ReflectFlag( Camera, "MouseZooming", flags, MouseZooming ),
+			ReflectFlag( Camera, "ZoomCentreOnMouse", flags, ZoomCentreOnMouse ),
+			ReflectFlag( Camera, "AdditivePanning", flags, AdditivePanning ),
+			ReflectFlag( Camera, "NormaliseDiagonalPanning", flags, NormaliseDiagonalPanning ),
+			ReflectFlag( Camera, "StartActivated", flags, StartActivated ),
+			ReflectMemberIf( Camera, "PanSpeed", panSpeed, !Reflex::IsDefault( component.panSpeed ) ),
+			ReflectMemberIf( Camera, "PanMouseMargin", panMouseMargin, !Reflex::IsDefault( component.panMouseMargin ) ),
+			ReflectMemberIf( Camera, "FollowInterpSpeed", followInterpSpeed, component.followInterpSpeed ),
+			ReflectMemberIf( Camera, "ZoomScaleFactor", zoomScaleFactor, component.zoomScaleFactor ),
 		};
-	}
-
-	bool Camera::SetValue( const std::string& variable, const std::string& value )
-	{
-		static_assert( std::size( flagNames ) == ( size_t )NumFlags );
-
-		for( unsigned i = 0; i < std::size( flagNames ); ++i )
-		{
-			if( variable == flagNames[i] )
-			{
-				flags.set( i, Reflex::FromString< bool >( value ) );
-				return true;
-			}
-		}
-
-		if( variable == "PanSpeed" )
-		{
-			panSpeed = Reflex::FromString< sf::Vector2f >( value );
-			return true;
-		}
-		else if( variable == "PanMouseMargin" )
-		{
-			panMouseMargin = Reflex::FromString< sf::Vector2f >( value );
-			return true;
-		}
-		else if( variable == "FollowInterpSpeed" )
-		{
-			followInterpSpeed = Reflex::FromString< float >( value );
-			return true;
-		}
-		else if( variable == "ZoomScaleFactor" )
-		{
-			zoomScaleFactor = Reflex::FromString< float >( value );
-			return true;
-		}
 
-		return false;
-	}
-
-	void Camera::GetValues( std::vector< std::pair< std::string, std::string > >& values ) const
-	{
-		for( unsigned i = 0; i < std::size( flagNames ); ++i )
-			if( flags.test( i ) )
-				values.emplace_back( flagNames[i], "true" );
-
-		if( !Reflex::IsDefault( panSpeed ) )
-			values.emplace_back( "PanSpeed", Reflex::ToString( panSpeed ) );
-		if( !Reflex::IsDefault( panMouseMargin ) )
-			values.emplace_back( "PanMouseMargin", Reflex::ToString( panMouseMargin ) );
-		if( followInterpSpeed )
-			values.emplace_back( "FollowInterpSpeed", Reflex::ToString( followInterpSpeed ) );
-		if( zoomScaleFactor )
-			values.emplace_back( "ZoomScaleFactor", Reflex::ToString( zoomScaleFactor ) );
+		return fields;
 	}
 
 	void Camera::OnConstructionComplete()
@@ -12,6 +12,9 @@ namespace Reflex::Systems
 	void CameraSystem::RegisterComponents()
 	{
 		RequiresComponent( Reflex::Components::Camera );
+		WritesComponent( Reflex::Components::Camera );
+		// Moves the active camera's transform and reads its follow target's
+		WritesComponent( Transform );
 	}
 
 	void CameraSystem::Update( const float deltaTime )
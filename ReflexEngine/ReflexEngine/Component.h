@@ -2,6 +2,7 @@
 
 #include "Precompiled.h"
 #include "BaseObject.h"
+#include "Reflection.h"
 
 #undef GetObject
 
@@ -12,7 +13,7 @@ namespace Reflex
 	template< class T >
 	class Handle;
 
-	namespace Core { class World; }
+	namespace Core { class World; class RenderBatch; }
 	namespace Systems { class RenderSystem; }
 }
 
@@ -32,6 +33,9 @@ namespace Reflex::Components
 		Reflex::Handle< Transform > GetTransform() const;
 		Reflex::Core::World& GetWorld() const;
 
+		// Serialisation, components with saved values hide this with their own table (built with the Reflect macros below)
+		static Reflex::Core::FieldTable GetFields() { return {}; }
+
 	protected:
 		BaseComponent() {}
 		BaseComponent( const BaseComponent& other );
@@ -40,13 +44,11 @@ namespace Reflex::Components
 		virtual void OnDestructionBegin() = 0;
 		static std::string GetComponentName() { assert( false ); }
 
-		// Serialisation
-		virtual bool SetValue( const std::string& variable, const std::string& value ) { return false; }
-		virtual void GetValues( std::vector< std::pair< std::string, std::string > >& values ) const { }
-
 		// Component rendering
 		virtual bool IsRenderComponent() const { return false; }
 		virtual void Render( sf::RenderTarget& target, sf::RenderStates states ) const { }
+		// Appends the component's triangles (transformed by transform) to the batch, components that return false are drawn individually with Render
+		virtual bool Batch( Reflex::Core::RenderBatch& batch, const sf::Transform& transform ) const { return false; }
 
 		BaseObject m_object;
 		static ComponentFamily s_componentFamilyIdx;
@@ -87,15 +89,29 @@ namespace Reflex::Components
 	};
 }
 
-// Helper macros used for serialisation
-#define TrySetValue( name, mem ) \
-	if( variable == name ) { \
-		mem = Reflex::FromString< decltype( mem ) >( value ); \
-		return true; } 
+// Helper macros used to build a component's field table (see Reflex::Core::Field)
+// getter, setter and cond are expressions using component (and value, the new value, for setter)
+#define ReflectMember( Class, name, member ) \
+	Reflex::Core::MakeMemberField< &Class::member >( name )
+
+#define ReflectMemberIf( Class, name, member, cond ) \
+	Reflex::Core::MakeMemberField< &Class::member >( name, ReflectCondition( Class, cond ) )
+
+#define ReflectProperty( Class, name, type, getter, setter ) \
+	ReflectPropertyInternal( Class, name, type, getter, setter, nullptr )
+
+#define ReflectPropertyIf( Class, name, type, getter, setter, cond ) \
+	ReflectPropertyInternal( Class, name, type, getter, setter, ReflectCondition( Class, cond ) )
+
+// A single bit of a bitset member, only saved when set
+#define ReflectFlag( Class, name, flags, index ) \
+	ReflectPropertyIf( Class, name, bool, component.flags[index], component.flags[index] = value, component.flags[index] )
 
-#define GetValue( name, mem ) \
-	values.emplace_back( name, Reflex::ToString( mem ) );
+#define ReflectCondition( Class, cond ) \
+	[]( const Reflex::Components::BaseComponent& base ) { const auto& component = static_cast< const Class& >( base ); return bool( cond ); }
 
-#define TryGetValue( name, mem, cond ) \
-	if( cond ) \
-		values.emplace_back( name, Reflex::ToString( mem ) );
+#define ReflectPropertyInternal( Class, name, type, getter, setter, shouldSave ) \
+	Reflex::Core::Field{ name, Reflex::Core::GetFieldType< type >(), \
+		[]( const Reflex::Components::BaseComponent& base ) -> Reflex::Core::FieldValue { const auto& component = static_cast< const Class& >( base ); return type( getter ); }, \
+		[]( Reflex::Components::BaseComponent& base, const Reflex::Core::FieldValue& fieldValue ) { auto& component = static_cast< Class& >( base ); const auto& value = std::get< type >( fieldValue ); setter; }, \
+		shouldSave }
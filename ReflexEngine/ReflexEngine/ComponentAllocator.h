@@ -1,18 +1,33 @@
 #pragma once
 
+#include "Reflection.h"
+
 namespace Reflex::Core
 {
+	// Indexed: components are stored at their object's index (fast lookup, but iteration strides across the whole object index space)
+	// Packed: components are stored contiguously in a dense array with a sparse object index -> slot lookup (sparse set)
+	//	Removing a component moves the last component into the freed slot, so packed components must not be referenced by address
+	//	(eg. event receivers or components used as Box2D user data should stay Indexed)
+	enum class ComponentStorage
+	{
+		Indexed,
+		Packed,
+	};
+
 	class ComponentAllocatorBase
 	{
 	public:
-		ComponentAllocatorBase( const std::size_t count, const std::size_t elementSize, const std::size_t chunkSize = 8192 )
+		static constexpr std::uint32_t InvalidSlot = std::numeric_limits< std::uint32_t >::max();
+
+		ComponentAllocatorBase( const std::size_t count, const std::size_t elementSize, const ComponentStorage storage = ComponentStorage::Indexed, const std::size_t chunkSize = 8192 )
 			: chunkSize( chunkSize )
 			, elementSize( elementSize )
+			, storage( storage )
 		{
 			ExpandToFit( count );
 		}
 
-		~ComponentAllocatorBase()
+		virtual ~ComponentAllocatorBase()
 		{
 			for( auto& chunk : data )
 				delete[] chunk;
@@ -24,6 +39,8 @@ namespace Reflex::Core
 		std::size_t GetChunkCount() const { return data.size(); }
 		std::size_t GetElementSize() const { return elementSize; }
 		std::size_t GetChunkSize() const { return chunkSize; }
+		ComponentStorage GetStorage() const { return storage; }
+		bool IsPacked() const { return storage == ComponentStorage::Packed; }
 
 		void Reserve( const std::size_t num )
 		{
@@ -36,11 +53,20 @@ namespace Reflex::Core
 			count = num;
 		}
 
+		// Indexed: makes sure there is storage for objects up to num
+		// Packed: only the sparse lookup grows, the dense storage grows as components are constructed
 		void ExpandToFit( const std::size_t num )
 		{
-			if( num > count ) 
+			if( IsPacked() )
+			{
+				if( num > sparse.size() )
+					sparse.resize( num, InvalidSlot );
+				return;
+			}
+
+			if( num > count )
 			{
-				if( num >= capacity ) 
+				if( num >= capacity )
 					Reserve( num );
 				count = num;
 			}
@@ -52,35 +78,95 @@ namespace Reflex::Core
 			capacity += chunkSize;
 		}
 
-		void* Get( const std::size_t index ) 
+		void* Get( const std::size_t index )
 		{
-			assert( index < count );
-			return static_cast< void* >( data[index / chunkSize] + ( index % chunkSize ) * elementSize );
+			return GetSlot( GetSlotIndex( index ) );
 		}
 
 		const void* Get( const std::size_t index ) const
 		{
-			assert( index < count );
-			return static_cast< const void* >( data[index / chunkSize] + ( index % chunkSize ) * elementSize );
+			return GetSlot( GetSlotIndex( index ) );
+		}
+
+		// Packed storage only: direct access to the dense array
+		void* GetSlot( const std::size_t slot )
+		{
+			assert( slot < count );
+			return static_cast< void* >( data[slot / chunkSize] + ( slot % chunkSize ) * elementSize );
+		}
+
+		const void* GetSlot( const std::size_t slot ) const
+		{
+			assert( slot < count );
+			return static_cast< const void* >( data[slot / chunkSize] + ( slot % chunkSize ) * elementSize );
+		}
+
+		// Raw chunk storage, used by views to resolve a chunk's base pointer once instead of per component
+		void* GetChunkData( const std::size_t chunk )
+		{
+			assert( chunk < data.size() );
+			return static_cast< void* >( data[chunk] );
+		}
+
+		std::uint32_t GetSlotObjectIndex( const std::size_t slot ) const
+		{
+			assert( IsPacked() && slot < dense.size() );
+			return dense[slot];
+		}
+
+		bool HasSlot( const std::size_t index ) const
+		{
+			return index < sparse.size() && sparse[index] != InvalidSlot;
 		}
 
 		virtual void* ConstructEmpty( const size_t index, const Object& object ) = 0;
 		virtual void Destroy( const std::size_t index ) = 0;
+		// The component type's serialised fields
+		virtual FieldTable GetFields() const = 0;
+
+	protected:
+		std::size_t GetSlotIndex( const std::size_t index ) const
+		{
+			if( !IsPacked() )
+				return index;
+
+			assert( HasSlot( index ) );
+			return sparse[index];
+		}
+
+		// Packed storage: claims the next slot in the dense array for the object index
+		std::size_t AllocateSlot( const std::size_t index )
+		{
+			assert( IsPacked() && !HasSlot( index ) );
+			ExpandToFit( index + 1 );
+
+			const auto slot = count;
+			Reserve( slot + 1 );
+			sparse[index] = ( std::uint32_t )slot;
+			dense.push_back( ( std::uint32_t )index );
+			++count;
+			return slot;
+		}
 
 	protected:
 		std::vector< char* > data;
 		const std::size_t elementSize = 0;
 		const std::size_t chunkSize = 0;
+		const ComponentStorage storage = ComponentStorage::Indexed;
 		std::size_t count = 0;
 		std::size_t capacity = 0;
+
+		// Packed storage lookups (object index -> slot, slot -> object index)
+		std::vector< std::uint32_t > sparse;
+		std::vector< std::uint32_t > dense;
 	};
 
 	template< typename T >
 	class ComponentAllocator : public ComponentAllocatorBase
 	{
 	public:
-		ComponentAllocator( const std::size_t count, const std::size_t chunkSize = 8192 )
-			: ComponentAllocatorBase( count, sizeof( T ), chunkSize )
+		ComponentAllocator( const std::size_t count, const ComponentStorage storage = ComponentStorage::Indexed, const std::size_t chunkSize = 8192 )
+			: ComponentAllocatorBase( count, sizeof( T ), storage, chunkSize )
 		{
 		}
 
@@ -99,9 +185,20 @@ namespace Reflex::Core
 			return ( void* )Construct( index, object );
 		}
 
+		FieldTable GetFields() const
+		{
+			return T::GetFields();
+		}
+
 		template< typename... Args >
 		T* Construct( const std::size_t index, Args&& ... args )
 		{
+			if( IsPacked() )
+			{
+				const auto slot = AllocateSlot( index );
+				return new( GetSlot( slot ) ) T( std::forward<Args>( args )... );
+			}
+
 			ExpandToFit( index );
 			assert( index < count );
 			new( Get( index ) ) T( std::forward<Args>( args )... );
@@ -110,8 +207,49 @@ namespace Reflex::Core
 
 		void Destroy( const std::size_t index )
 		{
-			assert( index < count );
-			Get( index )->~T();
+			if( !IsPacked() )
+			{
+				assert( index < count );
+				Get( index )->~T();
+				return;
+			}
+
+			// Swap and pop, the last component is relocated into the freed slot
+			const auto slot = GetSlotIndex( index );
+			const auto last = count - 1;
+			auto* removed = static_cast< T* >( GetSlot( slot ) );
+			removed->~T();
+
+			if( slot != last )
+			{
+				auto* moved = static_cast< T* >( GetSlot( last ) );
+				new( removed ) T( std::move( *moved ) );
+				moved->~T();
+				dense[slot] = dense[last];
+				sparse[dense[slot]] = ( std::uint32_t )slot;
+			}
+
+			sparse[index] = InvalidSlot;
+			dense.pop_back();
+			--count;
+		}
+
+		// Packed storage only: calls function( objectIndex, T& ) for every live component, walking the dense array chunk by chunk
+		template< typename Func >
+		void ForEachPacked( Func function )
+		{
+			assert( IsPacked() );
+
+			for( std::size_t chunk = 0, slot = 0; slot < count; ++chunk )
+			{
+				auto* components = reinterpret_cast< T* >( data[chunk] );
+				const auto end = std::min( count - slot, chunkSize );
+
+				for( std::size_t i = 0; i < end; ++i )
+					function( dense[slot + i], components[i] );
+
+				slot += end;
+			}
 		}
 	};
 }
\ No newline at end of file
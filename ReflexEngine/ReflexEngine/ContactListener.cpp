@@ -0,0 +1,84 @@
+#include "Precompiled.h"
+#include "ContactListener.h"
+#include "Object.h"
+
+namespace Reflex::Core
+{
+	namespace
+	{
+		// Bodies created by a RigidBody store the owning object as user data, bodies created directly on the b2World give a null object
+		BaseObject GetBodyObject( const b2Fixture* fixture )
+		{
+			const auto* object = static_cast< const Object* >( fixture->GetBody()->GetUserData() );
+			return object ? BaseObject( *object ) : BaseObject();
+		}
+	}
+
+	Object Contact::GetObjectA() const
+	{
+		return Object( objectA );
+	}
+
+	Object Contact::GetObjectB() const
+	{
+		return Object( objectB );
+	}
+
+	void ContactListener::BeginStep()
+	{
+		m_contacts.clear();
+		m_solvedContacts.clear();
+	}
+
+	void ContactListener::BeginContact( b2Contact* contact )
+	{
+		Record( contact, ContactType::Begin );
+	}
+
+	void ContactListener::EndContact( b2Contact* contact )
+	{
+		Record( contact, ContactType::End );
+	}
+
+	void ContactListener::PreSolve( b2Contact* contact, const b2Manifold* oldManifold )
+	{
+		if( auto* record = Record( contact, ContactType::PreSolve ) )
+			m_solvedContacts[contact] = record - m_contacts.data();
+	}
+
+	void ContactListener::PostSolve( b2Contact* contact, const b2ContactImpulse* impulse )
+	{
+		const auto found = m_solvedContacts.find( contact );
+		if( found == m_solvedContacts.end() )
+			return;
+
+		// Continuous collision can solve a contact twice in one step, the impulses are accumulated
+		auto& record = m_contacts[found->second];
+		for( int32 i = 0; i < impulse->count; ++i )
+		{
+			record.normalImpulse += impulse->normalImpulses[i];
+			record.tangentImpulse += impulse->tangentImpulses[i];
+		}
+	}
+
+	Contact* ContactListener::Record( b2Contact* contact, const ContactType type )
+	{
+		// Destroying a body ends its contacts outside of a step, the objects involved are being destroyed so these aren't reported
+		if( !contact->GetFixtureA()->GetBody()->GetWorld()->IsLocked() )
+			return nullptr;
+
+		b2WorldManifold manifold;
+		contact->GetWorldManifold( &manifold );
+
+		auto& record = m_contacts.emplace_back();
+		record.type = type;
+		record.fixtureA = contact->GetFixtureA();
+		record.fixtureB = contact->GetFixtureB();
+		record.objectA = GetBodyObject( record.fixtureA );
+		record.objectB = GetBodyObject( record.fixtureB );
+		record.pointCount = ( unsigned )contact->GetManifold()->pointCount;
+		record.normal = sf::Vector2f( manifold.normal.x, manifold.normal.y );
+		record.point = record.pointCount > 0 ? Reflex::B2VecToVector2f( manifold.points[0] ) : sf::Vector2f();
+		return &record;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "BaseObject.h"
+#include <box2d.h>
+
+namespace Reflex { class Object; }
+
+namespace Reflex::Core
+{
+	enum class ContactType : std::uint8_t
+	{
+		Begin,
+		End,
+		PreSolve,
+	};
+
+	// A contact reported by Box2D during the last step, positions are in world units
+	struct Contact
+	{
+		ContactType type = ContactType::Begin;
+		b2Fixture* fixtureA = nullptr;
+		b2Fixture* fixtureB = nullptr;
+		// Points from A to B
+		sf::Vector2f normal;
+		sf::Vector2f point;
+		unsigned pointCount = 0U;
+		// Summed over the manifold points, only set on PreSolve contacts that reached the solver (sensors and sleeping bodies have none)
+		float normalImpulse = 0.0f;
+		float tangentImpulse = 0.0f;
+
+		Object GetObjectA() const;
+		Object GetObjectB() const;
+
+		BaseObject objectA;
+		BaseObject objectB;
+	};
+
+	// Records Box2D contact callbacks into a flat buffer instead of dispatching them through the EventManager one at a time
+	// The buffer is cleared at the start of each step, systems in the Physics stage read it after the step (see World::GetContacts)
+	class ContactListener : public b2ContactListener
+	{
+	public:
+		void BeginStep();
+
+		void BeginContact( b2Contact* contact ) override;
+		void EndContact( b2Contact* contact ) override;
+		void PreSolve( b2Contact* contact, const b2Manifold* oldManifold ) override;
+		void PostSolve( b2Contact* contact, const b2ContactImpulse* impulse ) override;
+
+		const std::vector< Contact >& GetContacts() const { return m_contacts; }
+
+	protected:
+		Contact* Record( b2Contact* contact, const ContactType type );
+
+	private:
+		std::vector< Contact > m_contacts;
+		// Latest PreSolve record of each contact, PostSolve writes the impulses there
+		std::unordered_map< b2Contact*, std::size_t > m_solvedContacts;
+	};
+}
\ No newline at end of file
@@ -6,14 +6,14 @@
 namespace Reflex::Core
 {
 	Engine::Engine( const std::string& windowName, const bool fullscreen )
-		: m_world( Context( m_window, m_textureManager, m_fontManager ), m_params.worldBounds, m_params.gravity )
+		: m_world( Context( m_window, m_textureManager, m_fontManager ), m_params.worldBounds, m_params.gravity, m_params.workerThreads )
 		, m_stateManager( m_world )
 	{
 		Setup();
 	}
 
 	Engine::Engine( const std::string& windowName, const int screenWidth, const int screenHeight )
-		: m_world( Context( m_window, m_textureManager, m_fontManager ), m_params.worldBounds, m_params.gravity )
+		: m_world( Context( m_window, m_textureManager, m_fontManager ), m_params.worldBounds, m_params.gravity, m_params.workerThreads )
 		, m_stateManager( m_world )
 	{
 		m_params.videoMode.width = screenWidth;
@@ -23,14 +23,14 @@ namespace Reflex::Core
 
 	Engine::Engine( const Engine::EngineParams& params )
 		: m_params( params )
-		, m_world( Context( m_window, m_textureManager, m_fontManager ), m_params.worldBounds, m_params.gravity )
+		, m_world( Context( m_window, m_textureManager, m_fontManager ), m_params.worldBounds, m_params.gravity, m_params.workerThreads )
 		, m_stateManager( m_world )
 	{
 		Setup();
 	}
 
 	Engine::Engine( const bool createWindow, const int fixedUpdatesPerSecond, const bool enableProfiling )
-		: m_world( Context( m_window, m_textureManager, m_fontManager ), m_params.worldBounds, m_params.gravity )
+		: m_world( Context( m_window, m_textureManager, m_fontManager ), m_params.worldBounds, m_params.gravity, m_params.workerThreads )
 		, m_stateManager( m_world )
 	{
 		m_params.cmdMode = !createWindow;
@@ -159,6 +159,10 @@ namespace Reflex::Core
 	void Engine::Update( const float deltaTime )
 	{
 		m_stateManager.Update( deltaTime );
+
+		// Without a window there is nothing else to close, so headless runs (eg. benchmarks) end once every state has been removed
+		if( m_params.cmdMode && m_stateManager.IsEmpty() )
+			Exit();
 	}
 
 	void Engine::Render()
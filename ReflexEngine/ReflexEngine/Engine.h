@@ -29,6 +29,9 @@ namespace Reflex::Core
 
 			// Command Line Mode: Don't create a window - this is used for the unit tests project
 			bool cmdMode = false;
+
+			// Job system worker threads (-1 uses one less than the hardware thread count, 0 runs all systems on the main thread)
+			int workerThreads = -1;
 		};
 
 		// Construct an engine instance
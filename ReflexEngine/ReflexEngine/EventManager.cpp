@@ -19,11 +19,161 @@ namespace Reflex::Core
 	EventReceiver::~EventReceiver()
 	{
 		if( eventManager )
-			eventManager->Unsubscribe( *this );
+			eventManager->RemoveReceiver( *this );
 	}
 
 	EventTriggerer::~EventTriggerer()
 	{
 		eventManager.RemoveTriggerer( *this );
 	}
+
+	void EventManager::RemoveTriggerer( EventTriggerer& triggerer )
+	{
+		if( !triggerer.triggererIndex )
+			return;
+
+		const auto triggererIdx = *triggerer.triggererIndex;
+
+		for( auto& typeReceivers : m_triggererSubscribers[triggererIdx] )
+			for( auto& receiver : typeReceivers.receivers )
+				m_receiverSubscriptions[receiver.receiverIndex].erase( triggererIdx );
+
+		// Cleared rather than released so the buckets keep their allocations when the index is reused
+		m_triggererSubscribers[triggererIdx].clear();
+		m_triggererGenerations[triggererIdx]++;
+		m_freeTriggererIndices.push_back( triggererIdx );
+		triggerer.triggererIndex = std::nullopt;
+	}
+
+	void EventManager::RemoveReceiver( EventReceiver& receiver )
+	{
+		if( !receiver.receiverIndex )
+			return;
+
+		UnsubscribeInternal( nullptr, receiver );
+		m_freeReceiverIndices.push_back( *receiver.receiverIndex );
+		receiver.receiverIndex = std::nullopt;
+		receiver.eventManager = nullptr;
+	}
+
+	void EventManager::Flush()
+	{
+		PROFILE;
+
+		// Indexed as receivers can queue new event types while flushing
+		for( size_t type = 0; type < m_queues.size(); ++type )
+			if( m_queues[type] )
+				m_queues[type]->Flush( *this );
+	}
+
+	void EventManager::AddSubscription( const unsigned triggererIdx, EventReceiver& receiver, const size_t type, const EventDelegate& delegate )
+	{
+		if( !receiver.receiverIndex )
+		{
+			receiver.receiverIndex = AllocateIndex( m_receiverSubscriptions, m_freeReceiverIndices );
+			receiver.eventManager = this;
+		}
+
+		// Already subscribed? Don't subscribe twice
+		auto& subscribedTypes = m_receiverSubscriptions[*receiver.receiverIndex][triggererIdx];
+		if( Reflex::Contains( subscribedTypes, type ) )
+			return;
+
+		subscribedTypes.push_back( type );
+		GetReceivers( triggererIdx, type ).push_back( { delegate, *receiver.receiverIndex } );
+	}
+
+	void EventManager::UnsubscribeInternal( EventTriggerer* triggerer, EventReceiver& receiver )
+	{
+		if( !receiver.receiverIndex || ( triggerer && !triggerer->triggererIndex ) )
+			return;
+
+		auto& subscriptions = m_receiverSubscriptions[*receiver.receiverIndex];
+
+		if( triggerer )
+		{
+			const auto found = subscriptions.find( *triggerer->triggererIndex );
+			if( found == subscriptions.end() )
+				return;
+
+			EraseReceiver( found->first, found->second, *receiver.receiverIndex );
+			subscriptions.erase( found );
+			return;
+		}
+
+		for( const auto& [triggererIdx, types] : subscriptions )
+			EraseReceiver( triggererIdx, types, *receiver.receiverIndex );
+
+		subscriptions.clear();
+	}
+
+	void EventManager::EraseReceiver( const unsigned triggererIdx, const std::vector< size_t >& types, const unsigned receiverIdx )
+	{
+		for( const auto type : types )
+		{
+			auto* receivers = FindReceivers( triggererIdx, type );
+			assert( receivers );
+
+			Reflex::EraseIf( *receivers, [&]( const ReceiverInstance& instance )
+			{
+				return instance.receiverIndex == receiverIdx;
+			} );
+		}
+	}
+
+	unsigned EventManager::GetTriggererIndex( EventTriggerer& triggerer )
+	{
+		if( !triggerer.triggererIndex )
+		{
+			triggerer.triggererIndex = AllocateIndex( m_triggererSubscribers, m_freeTriggererIndices );
+			m_triggererGenerations.resize( m_triggererSubscribers.size() );
+		}
+
+		return *triggerer.triggererIndex;
+	}
+
+	std::vector< EventManager::ReceiverInstance >* EventManager::FindReceivers( const unsigned triggererIdx, const size_t type )
+	{
+		if( triggererIdx == AnyTriggerer )
+			return type < m_globalSubscribers.size() ? &m_globalSubscribers[type] : nullptr;
+
+		if( triggererIdx == BatchReceivers )
+			return type < m_batchSubscribers.size() ? &m_batchSubscribers[type] : nullptr;
+
+		for( auto& typeReceivers : m_triggererSubscribers[triggererIdx] )
+			if( typeReceivers.type == type )
+				return &typeReceivers.receivers;
+
+		return nullptr;
+	}
+
+	std::vector< EventManager::ReceiverInstance >& EventManager::GetReceivers( const unsigned triggererIdx, const size_t type )
+	{
+		if( auto* receivers = FindReceivers( triggererIdx, type ) )
+			return *receivers;
+
+		if( triggererIdx == AnyTriggerer || triggererIdx == BatchReceivers )
+		{
+			auto& subscribers = triggererIdx == AnyTriggerer ? m_globalSubscribers : m_batchSubscribers;
+			subscribers.resize( type + 1 );
+			return subscribers[type];
+		}
+
+		auto& typeReceivers = m_triggererSubscribers[triggererIdx];
+		typeReceivers.push_back( { type, {} } );
+		return typeReceivers.back().receivers;
+	}
+
+	void EventManager::Dispatch( const std::optional< unsigned > triggererIdx, const size_t type, const void* event )
+	{
+		// Receivers of this triggerer only, then receivers of every triggerer
+		if( triggererIdx )
+			if( auto* receivers = FindReceivers( *triggererIdx, type ) )
+				for( auto& receiver : *receivers )
+					receiver.delegate( event );
+
+		if( type < m_globalSubscribers.size() )
+			for( auto& receiver : m_globalSubscribers[type] )
+				receiver.delegate( event );
+	}
 }
\ No newline at end of file
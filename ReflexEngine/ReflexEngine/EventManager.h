@@ -4,16 +4,14 @@
 
 #include <memory>
 #include <vector>
-#include <functional>
+#include <unordered_map>
+#include <mutex>
 
 namespace Reflex::Core
 {
 	class EventManager
 	{
 	public:
-		template < class EventType >
-		using callType = std::function< void( const EventType& ) >;
-
 		template< typename EventType, typename ReceiverType >
 		void Subscribe( ReceiverType& receiver, void ( ReceiverType::*func )( const EventType& ) )
 		{	
@@ -26,109 +24,191 @@ namespace Reflex::Core
 			SubscribeInternal( &triggerer, receiver, func );
 		}
 
+		// Batch receivers get every queued event of a type in a single call when the queues are flushed (emitted events aren't batched)
+		template< typename EventType, typename ReceiverType >
+		void SubscribeBatch( ReceiverType& receiver, void ( ReceiverType::* func )( const std::vector< EventType >& ) )
+		{
+			static_assert( std::is_convertible<ReceiverType*, EventReceiver*>::value, "To receive events you must inherit from Reflex::EventReceiver" );
+			AddSubscription( BatchReceivers, receiver, Event< EventType >::GetType(), EventDelegate::Create( receiver, func ) );
+		}
+
 		void Unsubscribe( EventReceiver& receiver )
 		{
-			UnsubscribeInternal( nullptr, &receiver );
+			UnsubscribeInternal( nullptr, receiver );
 		}
 
 		void Unsubscribe( EventTriggerer& triggerer, EventReceiver& receiver )
 		{
-			UnsubscribeInternal( &triggerer, &receiver );
+			UnsubscribeInternal( &triggerer, receiver );
 		}
 
-		void RemoveTriggerer( EventTriggerer& triggerer )
+		// Drop every subscription to / of a destroyed triggerer or receiver and recycle its index
+		void RemoveTriggerer( EventTriggerer& triggerer );
+		void RemoveReceiver( EventReceiver& receiver );
+
+		template< typename EventType >
+		void Emit( EventTriggerer& triggerer, const EventType& event )
 		{
-			UnsubscribeInternal( &triggerer, nullptr );
+			Dispatch( triggerer.triggererIndex, Event< EventType >::GetType(), &event );
 		}
 
+		// Stores the event to be delivered on the next Flush instead of immediately, so receivers aren't called in the middle of the sender's work
+		// Safe to call from systems updating concurrently
 		template< typename EventType >
-		void Emit( EventTriggerer& triggerer, const EventType& event )
+		void Queue( const EventTriggerer& triggerer, const EventType& event );
+
+		// Delivers every event queued before the call, type by type in the order they were queued, then hands each type's events to its batch receivers
+		// Events queued by receivers during the flush are kept for the next one
+		void Flush();
+
+	private:
+		struct ReceiverInstance
+		{
+			EventDelegate delegate;
+			unsigned receiverIndex;
+		};
+
+		struct TypeReceivers
 		{
-			if( !triggerer.triggererIndex )
-				triggerer.triggererIndex = nextTriggererIndex++;
+			size_t type;
+			std::vector< ReceiverInstance > receivers;
+		};
 
-			size_t type = Event< EventType >::GetType();
-			if( type >= m_subscribers.size() )
-				m_subscribers.resize( type + 1 );
+		// Used in place of a triggerer index for subscriptions to every triggerer and for batch subscriptions
+		static constexpr unsigned AnyTriggerer = std::numeric_limits< unsigned >::max();
+		static constexpr unsigned BatchReceivers = AnyTriggerer - 1;
 
-			Event< EventType > eventWrapper( event );
-			for( auto& receiver : m_subscribers[type] )
-				if( !receiver.triggererIndex || receiver.triggererIndex == triggerer.triggererIndex )
-					receiver.functor( eventWrapper );
-		}
+		struct QueuedTriggerer
+		{
+			unsigned index = AnyTriggerer;
+			// Triggerer indices are recycled, a queued event only goes to the triggerer's receivers if the index wasn't released since
+			unsigned generation = 0;
+		};
 
-		template< typename EventType >
-		struct CallbackWrapper
+		struct BaseEventQueue
 		{
-			CallbackWrapper( callType< EventType > callable ) : m_callable( callable ) {}
+			virtual ~BaseEventQueue() { }
+			virtual void Flush( EventManager& eventManager ) = 0;
+		};
 
-			void operator() ( const BaseEvent& event ) 
-			{
-				m_callable( static_cast< const Event< EventType >& >( event ).event );
-			}
+		// Events are double buffered, the pending buffers are swapped out on flush and both keep their allocations between frames
+		template< typename EventType >
+		struct EventQueue : BaseEventQueue
+		{
+			void Flush( EventManager& eventManager ) final { eventManager.FlushQueue( *this ); }
 
-			callType< EventType > m_callable;
+			std::vector< EventType > pending;
+			std::vector< QueuedTriggerer > pendingTriggerers;
+			std::vector< EventType > flushing;
+			std::vector< QueuedTriggerer > flushingTriggerers;
 		};
 
-	private:
 		template< typename EventType, typename ReceiverType >
 		void SubscribeInternal( EventTriggerer* triggerer, ReceiverType& receiver, void ( ReceiverType::* func )( const EventType& ) )
 		{
 			static_assert( std::is_convertible<ReceiverType*, EventReceiver*>::value, "To receive events you must inherit from Reflex::EventReceiver" );
+			AddSubscription( triggerer ? GetTriggererIndex( *triggerer ) : AnyTriggerer, receiver, Event< EventType >::GetType(), EventDelegate::Create( receiver, func ) );
+		}
 
-			if( triggerer && !triggerer->triggererIndex )
-				triggerer->triggererIndex = nextTriggererIndex++;
-
-			const auto callable = callType< EventType >( std::bind( func, &receiver, std::placeholders::_1 ) );
-			
-			if( !receiver.receiverIndex )
-			{
-				receiver.receiverIndex = nextReceiverIndex++;
-				receiver.eventManager = this;
-			}
+		void AddSubscription( const unsigned triggererIdx, EventReceiver& receiver, const size_t type, const EventDelegate& delegate );
+		void UnsubscribeInternal( EventTriggerer* triggerer, EventReceiver& receiver );
+		void EraseReceiver( const unsigned triggererIdx, const std::vector< size_t >& types, const unsigned receiverIdx );
 
-			size_t type = Event<EventType>::GetType();
-			if( type >= m_subscribers.size() )
-				m_subscribers.resize( type + 1 );
+		unsigned GetTriggererIndex( EventTriggerer& triggerer );
+		std::vector< ReceiverInstance >* FindReceivers( const unsigned triggererIdx, const size_t type );
+		std::vector< ReceiverInstance >& GetReceivers( const unsigned triggererIdx, const size_t type );
 
-			const auto triggererIdx = triggerer ? triggerer->triggererIndex : std::nullopt;
+		void Dispatch( const std::optional< unsigned > triggererIdx, const size_t type, const void* event );
 
-			// Already subscribed? Don't subscribe twice
-			if( Reflex::ContainsIf( m_subscribers[type], [&]( const ReceiverInstance& instance )
-			{
-				return instance.receiverIndex == triggererIdx && instance.receiverIndex == *receiver.receiverIndex;
-			} ) )
-				return;
+		template< typename EventType >
+		void FlushQueue( EventQueue< EventType >& queue );
+
+		template< typename T >
+		static unsigned AllocateIndex( std::vector< T >& slots, std::vector< unsigned >& freeIndices );
+
+		// Per triggerer index, the receivers of each event type it has subscribers for (only a handful, so searched linearly)
+		std::vector< std::vector< TypeReceivers > > m_triggererSubscribers;
+		std::vector< unsigned > m_triggererGenerations;
+		// Per event type, the receivers subscribed to every triggerer and the batch receivers
+		std::vector< std::vector< ReceiverInstance > > m_globalSubscribers;
+		std::vector< std::vector< ReceiverInstance > > m_batchSubscribers;
+		// Per receiver index, the event types subscribed to per triggerer index (or AnyTriggerer / BatchReceivers), so unsubscribing only visits those buckets
+		std::vector< std::unordered_map< unsigned, std::vector< size_t > > > m_receiverSubscriptions;
+
+		// Per event type, created on first use
+		std::vector< std::unique_ptr< BaseEventQueue > > m_queues;
+		std::mutex m_queueLock;
+
+		std::vector< unsigned > m_freeTriggererIndices;
+		std::vector< unsigned > m_freeReceiverIndices;
+	};
 
-			m_subscribers[type].push_back( { CallbackWrapper< EventType >( callable ), triggererIdx, *receiver.receiverIndex } );
+	// Template definitions
+	template< typename T >
+	unsigned EventManager::AllocateIndex( std::vector< T >& slots, std::vector< unsigned >& freeIndices )
+	{
+		if( freeIndices.empty() )
+		{
+			slots.emplace_back();
+			return ( unsigned )slots.size() - 1;
 		}
 
-		void UnsubscribeInternal( EventTriggerer* triggerer, EventReceiver* receiver )
+		const auto index = freeIndices.back();
+		freeIndices.pop_back();
+		return index;
+	}
+
+	template< typename EventType >
+	void EventManager::Queue( const EventTriggerer& triggerer, const EventType& event )
+	{
+		const size_t type = Event< EventType >::GetType();
+
+		// Triggerers without an index have no receivers of their own yet
+		QueuedTriggerer queued;
+		if( triggerer.triggererIndex )
+			queued = { *triggerer.triggererIndex, m_triggererGenerations[*triggerer.triggererIndex] };
+
+		std::lock_guard< std::mutex > lock( m_queueLock );
+
+		if( type >= m_queues.size() )
+			m_queues.resize( type + 1 );
+
+		if( !m_queues[type] )
+			m_queues[type] = std::make_unique< EventQueue< EventType > >();
+
+		auto& queue = static_cast< EventQueue< EventType >& >( *m_queues[type] );
+		queue.pending.push_back( event );
+		queue.pendingTriggerers.push_back( queued );
+	}
+
+	template< typename EventType >
+	void EventManager::FlushQueue( EventQueue< EventType >& queue )
+	{
 		{
-			assert( triggerer || receiver );
-
-			for( auto& eventType : m_subscribers )
-			{
-				Reflex::EraseIf( eventType, [&]( const ReceiverInstance& instance )
-				{
-					return ( !triggerer || ( triggerer->triggererIndex && instance.triggererIndex == triggerer->triggererIndex ) ) &&
-						( !receiver || ( receiver->receiverIndex && instance.receiverIndex == receiver->receiverIndex ) );
-						
-				} );
-			}
+			std::lock_guard< std::mutex > lock( m_queueLock );
+			std::swap( queue.pending, queue.flushing );
+			std::swap( queue.pendingTriggerers, queue.flushingTriggerers );
 		}
 
-		struct ReceiverInstance
+		if( queue.flushing.empty() )
+			return;
+
+		const size_t type = Event< EventType >::GetType();
+
+		for( size_t i = 0; i < queue.flushing.size(); ++i )
 		{
-			callType< BaseEvent > functor;
-			std::optional< unsigned > triggererIndex;
-			unsigned receiverIndex;
-		};
+			const auto& triggerer = queue.flushingTriggerers[i];
+			const auto valid = triggerer.index != AnyTriggerer && m_triggererGenerations[triggerer.index] == triggerer.generation;
+			Dispatch( valid ? std::optional< unsigned >( triggerer.index ) : std::nullopt, type, &queue.flushing[i] );
+		}
 
-		unsigned nextTriggererIndex = 0;
-		unsigned nextReceiverIndex = 0;
-		std::vector< std::vector< ReceiverInstance > > m_subscribers;
-	};
+		if( type < m_batchSubscribers.size() )
+			for( auto& receiver : m_batchSubscribers[type] )
+				receiver.delegate( &queue.flushing );
+
+		queue.flushing.clear();
+		queue.flushingTriggerers.clear();
+	}
 
 	template< typename EventType, typename ReceiverType >
 	void EventTriggerer::Subscribe( ReceiverType& receiver, void ( ReceiverType::* func )( const EventType& ) )
@@ -147,4 +227,10 @@ namespace Reflex::Core
 	{
 		eventManager.Emit( *this, event );
 	}
+
+	template< typename EventType >
+	void EventTriggerer::Queue( const EventType& event )
+	{
+		eventManager.Queue( *this, event );
+	}
 }
\ No newline at end of file
@@ -3,10 +3,9 @@ namespace Reflex::Core
 {
 	class EventManager;
 
-	// Event object itself
+	// Event type ids
 	struct BaseEvent
 	{
-		virtual ~BaseEvent() {}
 	protected:
 		static size_t typeCounter;
 	};
@@ -19,9 +18,28 @@ namespace Reflex::Core
 			static size_t type = BaseEvent::typeCounter++;
 			return type;
 		}
+	};
+
+	// Callback to a receiver's member function stored inline (receiver, member function pointer and a thunk typed for both), so creating one never allocates
+	// Called with a type erased pointer to the event, which must be of the event type it was created for
+	class EventDelegate
+	{
+	public:
+		template< typename EventType, typename ReceiverType >
+		static EventDelegate Create( ReceiverType& receiver, void ( ReceiverType::* func )( const EventType& ) );
+
+		void operator()( const void* event ) const { m_thunk( *this, event ); }
+
+	private:
+		template< typename EventType, typename ReceiverType >
+		static void Invoke( const EventDelegate& delegate, const void* event );
 
-		Event( const EventType& event ) : event( event ) {}
-		const EventType& event;
+		using Thunk = void( * )( const EventDelegate&, const void* );
+
+		void* m_receiver = nullptr;
+		Thunk m_thunk = nullptr;
+		// Member function pointers of classes with multiple or virtual inheritance are up to three pointers in size
+		unsigned char m_function[3 * sizeof( void* )];
 	};
 
 	class World;
@@ -71,8 +89,32 @@ namespace Reflex::Core
 		template< typename EventType >
 		void Emit( const EventType& event );
 
+		template< typename EventType >
+		void Queue( const EventType& event );
+
 	private:
 		std::optional< unsigned > triggererIndex;
 		EventManager& eventManager;
 	};
+
+	// Template definitions
+	template< typename EventType, typename ReceiverType >
+	EventDelegate EventDelegate::Create( ReceiverType& receiver, void ( ReceiverType::* func )( const EventType& ) )
+	{
+		static_assert( sizeof( func ) <= sizeof( m_function ), "Member function pointer is too large for EventDelegate" );
+
+		EventDelegate delegate;
+		delegate.m_receiver = &receiver;
+		delegate.m_thunk = &Invoke< EventType, ReceiverType >;
+		std::memcpy( delegate.m_function, &func, sizeof( func ) );
+		return delegate;
+	}
+
+	template< typename EventType, typename ReceiverType >
+	void EventDelegate::Invoke( const EventDelegate& delegate, const void* event )
+	{
+		void ( ReceiverType::* func )( const EventType& );
+		std::memcpy( &func, delegate.m_function, sizeof( func ) );
+		( static_cast< ReceiverType* >( delegate.m_receiver )->*func )( *static_cast< const EventType* >( event ) );
+	}
 }
\ No newline at end of file
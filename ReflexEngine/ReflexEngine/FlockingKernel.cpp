@@ -0,0 +1,104 @@
+#include "Precompiled.h"
+#include "FlockingKernel.h"
+
+#ifdef REFLEX_FLOCKING_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Reflex::Systems
+{
+	namespace
+	{
+#ifdef REFLEX_FLOCKING_SSE
+		float HorizontalSum( const __m128 values )
+		{
+			alignas( 16 ) float lanes[4];
+			_mm_store_ps( lanes, values );
+			return ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] );
+		}
+#endif
+	}
+
+	void FlockingNeighbours::Clear()
+	{
+		x.clear();
+		y.clear();
+		velocityX.clear();
+		velocityY.clear();
+	}
+
+	void FlockingNeighbours::Add( const sf::Vector2f& position, const sf::Vector2f& velocity )
+	{
+		x.push_back( position.x );
+		y.push_back( position.y );
+		velocityX.push_back( velocity.x );
+		velocityY.push_back( velocity.y );
+	}
+
+	FlockingSums SumFlockingForces( const FlockingNeighbours& neighbours, const sf::Vector2f& position )
+	{
+#ifdef REFLEX_FLOCKING_SSE
+		const auto count = neighbours.Size();
+		const auto simdCount = count - count % 4;
+
+		const auto posX = _mm_set1_ps( position.x );
+		const auto posY = _mm_set1_ps( position.y );
+		const auto minMagnitude = _mm_set1_ps( 0.0001f );
+		const auto negativeZero = _mm_set1_ps( -0.0f );
+
+		auto alignmentX = _mm_setzero_ps(), alignmentY = _mm_setzero_ps();
+		auto cohesionX = _mm_setzero_ps(), cohesionY = _mm_setzero_ps();
+		auto separationX = _mm_setzero_ps(), separationY = _mm_setzero_ps();
+
+		for( std::size_t i = 0; i < simdCount; i += 4 )
+		{
+			const auto x = _mm_loadu_ps( neighbours.x.data() + i );
+			const auto y = _mm_loadu_ps( neighbours.y.data() + i );
+			const auto velocityX = _mm_loadu_ps( neighbours.velocityX.data() + i );
+			const auto velocityY = _mm_loadu_ps( neighbours.velocityY.data() + i );
+
+			// Same as Reflex::Normalise, velocities shorter than 0.0001 count as zero
+			const auto magnitude = _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( velocityX, velocityX ), _mm_mul_ps( velocityY, velocityY ) ) );
+			const auto moving = _mm_cmpgt_ps( magnitude, minMagnitude );
+			alignmentX = _mm_add_ps( alignmentX, _mm_and_ps( moving, _mm_div_ps( velocityX, magnitude ) ) );
+			alignmentY = _mm_add_ps( alignmentY, _mm_and_ps( moving, _mm_div_ps( velocityY, magnitude ) ) );
+
+			cohesionX = _mm_add_ps( cohesionX, x );
+			cohesionY = _mm_add_ps( cohesionY, y );
+
+			// direction / -distanceSq, with direction from the neighbour to the boid
+			const auto directionX = _mm_sub_ps( posX, x );
+			const auto directionY = _mm_sub_ps( posY, y );
+			const auto negativeDistanceSq = _mm_xor_ps( _mm_add_ps( _mm_mul_ps( directionX, directionX ), _mm_mul_ps( directionY, directionY ) ), negativeZero );
+			separationX = _mm_add_ps( separationX, _mm_div_ps( directionX, negativeDistanceSq ) );
+			separationY = _mm_add_ps( separationY, _mm_div_ps( directionY, negativeDistanceSq ) );
+		}
+
+		// Remaining neighbours that don't fill a register
+		auto sums = SumFlockingForcesScalar( neighbours, position, simdCount );
+		sums.alignment += sf::Vector2f( HorizontalSum( alignmentX ), HorizontalSum( alignmentY ) );
+		sums.cohesion += sf::Vector2f( HorizontalSum( cohesionX ), HorizontalSum( cohesionY ) );
+		sums.separation += sf::Vector2f( HorizontalSum( separationX ), HorizontalSum( separationY ) );
+		return sums;
+#else
+		return SumFlockingForcesScalar( neighbours, position );
+#endif
+	}
+
+	FlockingSums SumFlockingForcesScalar( const FlockingNeighbours& neighbours, const sf::Vector2f& position, const std::size_t begin )
+	{
+		FlockingSums sums;
+
+		for( auto i = begin; i < neighbours.Size(); ++i )
+		{
+			const sf::Vector2f nearbyPos( neighbours.x[i], neighbours.y[i] );
+			const auto direction = position - nearbyPos;
+
+			sums.alignment += Reflex::Normalise( sf::Vector2f( neighbours.velocityX[i], neighbours.velocityY[i] ) );
+			sums.cohesion += nearbyPos;
+			sums.separation += direction / -Reflex::GetMagnitudeSq( direction );
+		}
+
+		return sums;
+	}
+}
\ No newline at end of file
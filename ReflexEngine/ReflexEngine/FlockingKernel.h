@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Precompiled.h"
+
+// SSE2 is part of x64 (and enabled by default on x86 with MSVC), other targets use the scalar kernel
+#if defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) || defined( __SSE2__ )
+#define REFLEX_FLOCKING_SSE
+#endif
+
+namespace Reflex::Systems
+{
+	// A boid's neighbours gathered into separate arrays, so the kernel can process several neighbours per instruction
+	struct FlockingNeighbours
+	{
+		void Clear();
+		void Add( const sf::Vector2f& position, const sf::Vector2f& velocity );
+		std::size_t Size() const { return x.size(); }
+
+		std::vector< float > x;
+		std::vector< float > y;
+		std::vector< float > velocityX;
+		std::vector< float > velocityY;
+	};
+
+	// Per neighbour sums of the flocking forces, before they are averaged
+	struct FlockingSums
+	{
+		sf::Vector2f alignment;		// Normalised neighbour velocities
+		sf::Vector2f cohesion;		// Neighbour positions
+		sf::Vector2f separation;	// Direction from the boid to each neighbour over the squared distance
+	};
+
+	// Uses SSE when available, results match the scalar kernel within floating point rounding (the sums are added in a different order)
+	FlockingSums SumFlockingForces( const FlockingNeighbours& neighbours, const sf::Vector2f& position );
+	FlockingSums SumFlockingForcesScalar( const FlockingNeighbours& neighbours, const sf::Vector2f& position, const std::size_t begin = 0 );
+}
\ No newline at end of file
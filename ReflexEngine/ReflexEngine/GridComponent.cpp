@@ -31,32 +31,16 @@ namespace Reflex::Components
 		m_children.resize( GetTotalCells() );
 	}
 
-	bool Grid::SetValue( const std::string& variable, const std::string& value )
+	Reflex::Core::FieldTable Grid::GetFields()
 	{
-		if( variable == "GridSize" )
+		static constexpr Reflex::Core::Field fields[] =
 		{
-			m_gridSize = Reflex::FromString< sf::Vector2u >( value );
-			return true;
-		}
-		else if( variable == "CellSize" )
-		{
-			m_cellSize = Reflex::FromString< sf::Vector2f >( value );
-			return true;
-		}
-		else if( variable == "CentreGrid" )
-		{
-			m_centreGrid = Reflex::FromString< bool >( value );
-			return true;
-		}
+			ReflectMember( Grid, "GridSize", m_gridSize ),
+			ReflectMember( Grid, "CellSize", m_cellSize ),
+			ReflectMember( Grid, "CentreGrid", m_centreGrid ),
+		};
 
-		return false;
-	}
-
-	void Grid::GetValues( std::vector< std::pair< std::string, std::string > >& values ) const
-	{
-		values.emplace_back( "GridSize", Reflex::ToString( m_gridSize ) );
-		values.emplace_back( "CellSize", Reflex::ToString( m_cellSize ) );
-		values.emplace_back( "CentreGrid", Reflex::ToString( m_centreGrid ) );
+		return fields;
 	}
 
 	void Grid::AddToGrid( const Reflex::Object& handle, const unsigned x, const unsigned y )
@@ -72,17 +56,11 @@ namespace Reflex::Components
 			return;
 		}
 			
-		auto transform = handle.GetTransform();
-
-		if( transform->m_parent )
-			transform->m_parent.GetTransform()->DetachChild( handle );
-
+		// Attaching detaches from any previous parent and sets the render order / layer
 		const auto insertIndex = GetIndex( index );
 		m_children[insertIndex] = handle;
-		transform->m_parent = GetObject();
-		transform->IncrementZOrder();
-		transform->SetLayer( GetObject().GetTransform()->GetLayer() + 1 );
-		transform->setPosition( GetCellPositionRelative( index ) );
+		GetObject().GetTransform()->AttachChild( handle );
+		handle.GetTransform()->setPosition( GetCellPositionRelative( index ) );
 	}
 
 	Reflex::Object Grid::RemoveFromGrid( const unsigned x, const unsigned y )
@@ -9,6 +9,7 @@
 #include "Object.h"
 #include "System.h"
 #include "Utility.h"
+#include "View.h"
 
 #include "TransformComponent.h"
 #include "CameraComponent.h"
@@ -19,6 +20,7 @@
 #include "ColliderComponent.h"
 
 #include "RenderSystem.h"
+#include "RenderBatch.h"
 #include "InteractableSystem.h"
 #include "MovementSystem.h"
 #include "CameraSystem.h"
@@ -12,35 +12,16 @@ namespace Reflex::Components
 
 	}
 
-	bool Interactable::SetValue( const std::string& variable, const std::string& value )
+	Reflex::Core::FieldTable Interactable::GetFields()
 	{
-		if( variable == "SelectionIsToggle" )
+		static constexpr Reflex::Core::Field fields[] =
 		{
-			selectionIsToggle = Reflex::FromString< bool >( value );
-			return true;
-		}
-		else if( variable == "UnselectIfLostFocus" )
-		{
-			unselectIfLostFocus = Reflex::FromString< bool >( value );
-			return true;
-		}
-		else if( variable == "IsEnabled" )
-		{
-			isEnabled = Reflex::FromString< bool >( value );
-			return true;
-		}
-
-		return false;
-	}
+			ReflectMemberIf( Interactable, "SelectionIsToggle", selectionIsToggle, component.selectionIsToggle ),
+			ReflectMemberIf( Interactable, "UnselectIfLostFocus", unselectIfLostFocus, component.unselectIfLostFocus ),
+			ReflectMemberIf( Interactable, "IsEnabled", isEnabled, component.isEnabled ),
+		};
 
-	void Interactable::GetValues( std::vector< std::pair< std::string, std::string > >& values ) const
-	{
-		if( selectionIsToggle )
-			values.emplace_back( "SelectionIsToggle", "true" );
-		if( unselectIfLostFocus )
-			values.emplace_back( "UnselectIfLostFocus", "true" );
-		if( isEnabled )
-			values.emplace_back( "IsEnabled", "true" );
+		return fields;
 	}
 
 	bool Interactable::IsFocussed() const
@@ -15,9 +15,8 @@ namespace Reflex::Components
 
 		Interactable( const Reflex::Object& owner, const Reflex::Object& collisionObjectOverride = Reflex::Object() );
 
-		bool SetValue( const std::string& variable, const std::string& value ) override;
-		void GetValues( std::vector< std::pair< std::string, std::string > >& values ) const override;
 		static std::string GetComponentName() { return "Interactable"; }
+		static Reflex::Core::FieldTable GetFields();
 
 		// Settings, change as you want
 		bool selectionIsToggle = true;
@@ -12,6 +12,8 @@ namespace Reflex::Systems
 	{
 		RequiresComponent( Transform );
 		RequiresComponent( Interactable );
+		ReadsComponent( Transform );
+		WritesComponent( Interactable );
 	}
 
 	bool InteractableSystem::CheckCollision( const Reflex::Components::Transform::Handle& transform, const sf::FloatRect& localBounds, const sf::Vector2f& mousePosition ) const
@@ -0,0 +1,153 @@
+#include "Precompiled.h"
+#include "JobSystem.h"
+
+namespace Reflex::Core
+{
+	namespace
+	{
+		// Index of the queue owned by the current thread (0 for any thread that isn't a worker)
+		thread_local unsigned s_queueIndex = 0;
+	}
+
+	JobSystem::JobSystem( const int numWorkers )
+	{
+		const auto hardwareThreads = ( int )std::thread::hardware_concurrency();
+		const auto workerCount = numWorkers < 0 ? std::max( 0, hardwareThreads - 1 ) : numWorkers;
+
+		for( int i = 0; i <= workerCount; ++i )
+			m_queues.push_back( std::make_unique< WorkerQueue >() );
+
+		for( int i = 0; i < workerCount; ++i )
+			m_workers.emplace_back( &JobSystem::WorkerLoop, this, unsigned( i + 1 ) );
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard< std::mutex > lock( m_wakeMutex );
+			m_shutdown = true;
+		}
+
+		m_wakeCondition.notify_all();
+
+		for( auto& worker : m_workers )
+			worker.join();
+	}
+
+	void JobSystem::RunAndWait( std::vector< Job >& jobs )
+	{
+		if( jobs.empty() )
+			return;
+
+		Batch batch;
+		batch.remaining = ( unsigned )jobs.size();
+
+		for( auto& job : jobs )
+			Push( Task{ std::move( job ), &batch } );
+
+		Wait( batch.remaining );
+
+		if( batch.error )
+			std::rethrow_exception( batch.error );
+	}
+
+	void JobSystem::Push( Task task )
+	{
+		{
+			auto& queue = *m_queues[GetQueueIndex()];
+			std::lock_guard< std::mutex > lock( queue.mutex );
+			queue.tasks.push_back( std::move( task ) );
+		}
+
+		{
+			std::lock_guard< std::mutex > lock( m_wakeMutex );
+			++m_queuedTasks;
+		}
+
+		m_wakeCondition.notify_one();
+	}
+
+	bool JobSystem::TryRunTask( const unsigned queueIndex )
+	{
+		Task task;
+		bool found = false;
+
+		// Own queue first (newest work, likely still in cache)
+		{
+			auto& queue = *m_queues[queueIndex];
+			std::lock_guard< std::mutex > lock( queue.mutex );
+
+			if( !queue.tasks.empty() )
+			{
+				task = std::move( queue.tasks.back() );
+				queue.tasks.pop_back();
+				found = true;
+			}
+		}
+
+		// Steal the oldest work from the other queues
+		for( unsigned i = 1; !found && i < m_queues.size(); ++i )
+		{
+			auto& queue = *m_queues[( queueIndex + i ) % m_queues.size()];
+			std::lock_guard< std::mutex > lock( queue.mutex );
+
+			if( !queue.tasks.empty() )
+			{
+				task = std::move( queue.tasks.front() );
+				queue.tasks.pop_front();
+				found = true;
+			}
+		}
+
+		if( !found )
+			return false;
+
+		--m_queuedTasks;
+
+		// Exceptions are caught so they can't escape a worker thread, and so the batch is always counted down while other tasks still point at it
+		try
+		{
+			task.job();
+		}
+		catch( ... )
+		{
+			std::lock_guard< std::mutex > lock( task.batch->errorMutex );
+			if( !task.batch->error )
+				task.batch->error = std::current_exception();
+		}
+
+		--task.batch->remaining;
+		return true;
+	}
+
+	void JobSystem::Wait( const std::atomic< unsigned >& remaining )
+	{
+		const auto queueIndex = GetQueueIndex();
+
+		while( remaining > 0 )
+			if( !TryRunTask( queueIndex ) )
+				std::this_thread::yield();
+	}
+
+	void JobSystem::WorkerLoop( const unsigned queueIndex )
+	{
+		s_queueIndex = queueIndex;
+
+		while( true )
+		{
+			if( TryRunTask( queueIndex ) )
+				continue;
+
+			std::unique_lock< std::mutex > lock( m_wakeMutex );
+			m_wakeCondition.wait( lock, [this]() { return m_shutdown || m_queuedTasks > 0; } );
+
+			if( m_shutdown )
+				return;
+		}
+	}
+
+	unsigned JobSystem::GetQueueIndex() const
+	{
+		return s_queueIndex < m_queues.size() ? s_queueIndex : 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Precompiled.h"
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <condition_variable>
+
+namespace Reflex::Core
+{
+	// Work stealing job scheduler
+	// Each worker owns a queue, it pops its own work from the back and steals from the front of other queues when empty
+	// Threads waiting on jobs help execute queued work, so jobs can safely wait on jobs they spawned (eg. a ParallelFor inside a system update)
+	class JobSystem : private sf::NonCopyable
+	{
+	public:
+		typedef std::function< void() > Job;
+
+		// Passing -1 uses one less worker than there are hardware threads (the calling thread also executes jobs while waiting)
+		// Passing 0 runs every job on the calling thread
+		explicit JobSystem( const int numWorkers = -1 );
+		~JobSystem();
+
+		unsigned GetWorkerCount() const { return ( unsigned )m_workers.size(); }
+
+		// Runs all of the jobs and returns once they have all completed
+		// If a job throws the other jobs still run, the first exception is then rethrown here
+		void RunAndWait( std::vector< Job >& jobs );
+
+		// Splits [0, count) into batches of at least minBatchSize and calls function( begin, end ) for each batch across the workers
+		template< typename Func >
+		void ParallelFor( const std::size_t count, const std::size_t minBatchSize, Func function );
+
+	private:
+		// Shared by the tasks of one RunAndWait call
+		struct Batch
+		{
+			std::atomic< unsigned > remaining = 0;
+			std::mutex errorMutex;
+			std::exception_ptr error;
+		};
+
+		struct Task
+		{
+			Job job;
+			Batch* batch = nullptr;
+		};
+
+		struct WorkerQueue
+		{
+			std::mutex mutex;
+			std::deque< Task > tasks;
+		};
+
+		void Push( Task task );
+		bool TryRunTask( const unsigned queueIndex );
+		void Wait( const std::atomic< unsigned >& remaining );
+		void WorkerLoop( const unsigned queueIndex );
+		unsigned GetQueueIndex() const;
+
+	private:
+		// Queue 0 is shared by external threads (usually the main thread), worker i uses queue i + 1
+		std::vector< std::unique_ptr< WorkerQueue > > m_queues;
+		std::vector< std::thread > m_workers;
+
+		std::mutex m_wakeMutex;
+		std::condition_variable m_wakeCondition;
+		std::atomic< unsigned > m_queuedTasks = 0;
+		std::atomic< bool > m_shutdown = false;
+	};
+
+	// Template definitions
+	template< typename Func >
+	void JobSystem::ParallelFor( const std::size_t count, const std::size_t minBatchSize, Func function )
+	{
+		if( count == 0 )
+			return;
+
+		// A few batches per thread gives the stealing some slack for uneven work
+		const auto maxBatches = std::size_t( GetWorkerCount() + 1 ) * 4;
+		const auto numBatches = std::max( std::size_t( 1 ), std::min( maxBatches, count / std::max( std::size_t( 1 ), minBatchSize ) ) );
+
+		if( numBatches == 1 )
+		{
+			function( std::size_t( 0 ), count );
+			return;
+		}
+
+		const auto batchSize = ( count + numBatches - 1 ) / numBatches;
+		std::vector< Job > jobs;
+		jobs.reserve( numBatches );
+
+		for( std::size_t begin = 0; begin < count; begin += batchSize )
+		{
+			const auto end = std::min( count, begin + batchSize );
+			jobs.emplace_back( [&function, begin, end]() { function( begin, end ); } );
+		}
+
+		RunAndWait( jobs );
+	}
+}
\ No newline at end of file
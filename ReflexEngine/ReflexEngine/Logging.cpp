@@ -17,7 +17,7 @@ namespace Reflex::Core
 
 	void Profiler::StartProfile( const std::string& name )
 	{
-		if( !s_profilerEnabled )
+		if( !s_profilerEnabled || std::this_thread::get_id() != m_profilingThread )
 			return;
 
 		const auto found = m_profileData.find( name );
@@ -37,7 +37,7 @@ namespace Reflex::Core
 
 	void Profiler::EndProfile( const std::string& name )
 	{
-		if( !s_profilerEnabled )
+		if( !s_profilerEnabled || std::this_thread::get_id() != m_profilingThread )
 			return;
 
 		const auto found = m_profileData.find( name );
@@ -63,10 +63,17 @@ namespace Reflex::Core
 			data.second.shortestFrame = std::min( data.second.shortestFrame, data.second.currentFrame );
 			data.second.longestFrame = std::max( data.second.longestFrame, data.second.currentFrame );
 			data.second.totalDuration += data.second.currentFrame;
+			data.second.lastFrame = data.second.currentFrame;
 			data.second.currentFrame = 0;
 		}
 	}
 
+	sf::Int64 Profiler::GetLastFrameDuration( const std::string& name ) const
+	{
+		const auto found = m_profileData.find( name );
+		return found == m_profileData.end() ? 0 : found->second.lastFrame;
+	}
+
 	void Profiler::OutputResults( const std::string& file )
 	{
 		if( !s_profilerEnabled )
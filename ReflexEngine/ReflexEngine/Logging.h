@@ -2,6 +2,7 @@
 
 // Includes
 #include "VectorMap.h"
+#include <thread>
 
 #define PROFILING
 #define LOGGING
@@ -33,16 +34,20 @@ namespace Reflex
 			void StartProfile( const std::string& name );
 			void EndProfile( const std::string& name );
 			void FrameTick( const sf::Int64 frameTimeMS );
+
+			// Microseconds spent in the named scope during the last completed frame (0 if it wasn't hit)
+			sf::Int64 GetLastFrameDuration( const std::string& name ) const;
 			void OutputResults( const std::string& file );
 
 		protected:
-			Profiler() { }
+			Profiler() : m_profilingThread( std::this_thread::get_id() ) { }
 
 		private:
 			struct ProfileData
 			{
 				sf::Clock timer;
 				sf::Int64 currentFrame = 0;
+				sf::Int64 lastFrame = 0;
 				sf::Int64 shortestFrame = std::numeric_limits< int >::max();
 				sf::Int64 longestFrame = 0;
 				sf::Int64 totalDuration = 0;
@@ -54,6 +59,9 @@ namespace Reflex
 
 			sf::Int64 m_totalDuration = 0;
 
+			// Profile data isn't synchronised, so only scopes on the thread that created the profiler are recorded (jobs on worker threads are skipped)
+			const std::thread::id m_profilingThread;
+
 			Reflex::VectorMap< std::string, ProfileData > m_profileData;
 			static std::unique_ptr< Profiler > s_profiler;
 			static bool s_profilerEnabled;
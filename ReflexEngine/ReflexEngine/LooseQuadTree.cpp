@@ -0,0 +1,176 @@
+#include "Precompiled.h"
+#include "LooseQuadTree.h"
+#include "Object.h"
+#include "TransformComponent.h"
+
+namespace Reflex::Core
+{
+	LooseQuadTree::LooseQuadTree( const sf::FloatRect& bounds, const unsigned maxDepth )
+		: m_origin( bounds.left, bounds.top )
+		, m_size( std::max( bounds.width, bounds.height ) )
+		, m_maxDepth( std::min( maxDepth, 16U ) )
+	{
+		assert( m_size > 0.0f );
+		Reset();
+	}
+
+	void LooseQuadTree::Insert( const Object& object )
+	{
+		assert( object );
+		if( object )
+			InsertAt( object, Locate( GetObjectBounds( object ) ) );
+	}
+
+	void LooseQuadTree::Remove( const Object& object )
+	{
+		assert( object );
+		if( object )
+			RemoveAt( object, GetLocation( object ) );
+	}
+
+	void LooseQuadTree::ForEachCandidate( const sf::FloatRect& boundary, const CandidateCallback& callback ) const
+	{
+		for( const auto& obj : m_outside )
+			callback( Object( obj ) );
+
+		const auto right = boundary.left + boundary.width;
+		const auto bottom = boundary.top + boundary.height;
+
+		for( unsigned level = 0; level < m_levels.size(); ++level )
+		{
+			const auto& nodes = m_levels[level];
+			if( nodes.empty() )
+				continue;
+
+			// Range of nodes whose loose bounds (half a node bigger on each side) overlap the query
+			const auto nodeSize = GetNodeSize( level );
+			const auto maxNode = int( 1U << level ) - 1;
+			const auto toNode = [&]( const float value, const float offset ) { return std::clamp( int( std::floor( value / nodeSize + offset ) ), 0, maxNode ); };
+
+			const sf::Vector2i min( toNode( boundary.left - m_origin.x, -1.5f ), toNode( boundary.top - m_origin.y, -1.5f ) );
+			const sf::Vector2i max( toNode( right - m_origin.x, 0.5f ), toNode( bottom - m_origin.y, 0.5f ) );
+
+			if( ( right - m_origin.x ) / nodeSize + 0.5f < 0.0f || ( bottom - m_origin.y ) / nodeSize + 0.5f < 0.0f ||
+				( boundary.left - m_origin.x ) / nodeSize - 1.5f > maxNode || ( boundary.top - m_origin.y ) / nodeSize - 1.5f > maxNode )
+				continue;
+
+			// Sparse levels are cheaper to walk directly than to probe every overlapped node
+			const auto overlapped = std::size_t( max.x - min.x + 1 ) * std::size_t( max.y - min.y + 1 );
+
+			if( overlapped > nodes.size() )
+			{
+				for( const auto& [key, objects] : nodes )
+				{
+					const sf::Vector2i node( int( key >> 32 ), int( key & 0xFFFFFFFF ) );
+					if( node.x >= min.x && node.x <= max.x && node.y >= min.y && node.y <= max.y )
+						for( const auto& obj : objects )
+							callback( Object( obj ) );
+				}
+				continue;
+			}
+
+			for( int x = min.x; x <= max.x; ++x )
+			{
+				for( int y = min.y; y <= max.y; ++y )
+				{
+					const auto found = nodes.find( NodeKey( sf::Vector2i( x, y ) ) );
+					if( found == nodes.end() )
+						continue;
+
+					for( const auto& obj : found->second )
+						callback( Object( obj ) );
+				}
+			}
+		}
+	}
+
+	SpatialIndexLocation LooseQuadTree::Locate( const Object& object ) const
+	{
+		return Locate( GetObjectBounds( object ) );
+	}
+
+	SpatialIndexLocation LooseQuadTree::Locate( const sf::FloatRect& bounds ) const
+	{
+		const auto extent = std::max( bounds.width, bounds.height );
+		const auto centre = sf::Vector2f( bounds.left + bounds.width / 2.0f, bounds.top + bounds.height / 2.0f ) - m_origin;
+
+		SpatialIndexLocation location;
+
+		if( centre.x < 0.0f || centre.y < 0.0f || centre.x >= m_size || centre.y >= m_size || extent > m_size )
+		{
+			location.id = OutsideLevel;
+			return location;
+		}
+
+		// Deepest level whose nodes are at least as big as the object, its loose bounds then always contain it
+		unsigned level = m_maxDepth;
+		while( level > 0 && extent > GetNodeSize( level ) )
+			--level;
+
+		const auto nodeSize = GetNodeSize( level );
+		const auto maxNode = int( 1U << level ) - 1;
+		location.id = level;
+		location.cell = sf::Vector2i( std::min( int( centre.x / nodeSize ), maxNode ), std::min( int( centre.y / nodeSize ), maxNode ) );
+		return location;
+	}
+
+	void LooseQuadTree::Relocate( const Object& object, const SpatialIndexLocation& newLocation )
+	{
+		RemoveAt( object, GetLocation( object ) );
+		InsertAt( object, newLocation );
+	}
+
+	void LooseQuadTree::Clear()
+	{
+		m_levels.clear();
+		m_levels.resize( m_maxDepth + 1 );
+		m_outside.clear();
+	}
+
+	void LooseQuadTree::InsertAt( const Object& object, const SpatialIndexLocation& location )
+	{
+		if( location.id == OutsideLevel )
+			m_outside.push_back( object );
+		else
+			m_levels[location.id][NodeKey( location.cell )].push_back( object );
+
+		GetLocation( object ) = location;
+	}
+
+	void LooseQuadTree::RemoveAt( const Object& object, const SpatialIndexLocation& location )
+	{
+		const auto removeFrom = [&object]( std::vector< BaseObject >& objects )
+		{
+			const auto found = std::find( objects.begin(), objects.end(), object );
+			assert( found != objects.end() );
+			if( found == objects.end() )
+				return;
+
+			*found = objects.back();
+			objects.pop_back();
+		};
+
+		if( location.id == OutsideLevel )
+		{
+			removeFrom( m_outside );
+			return;
+		}
+
+		auto& nodes = m_levels[location.id];
+		const auto found = nodes.find( NodeKey( location.cell ) );
+		assert( found != nodes.end() );
+		if( found == nodes.end() )
+			return;
+
+		removeFrom( found->second );
+
+		// Empty nodes are erased so sparse levels stay cheap to walk
+		if( found->second.empty() )
+			nodes.erase( found );
+	}
+
+	std::uint64_t LooseQuadTree::NodeKey( const sf::Vector2i& node )
+	{
+		return ( std::uint64_t( std::uint32_t( node.x ) ) << 32 ) | std::uint64_t( std::uint32_t( node.y ) );
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "SpatialIndex.h"
+
+namespace Reflex::Core
+{
+	// Loose quadtree, objects are stored once by their bounds (see Transform::SetLocalBounds) so large objects aren't duplicated across cells
+	// Each node's loose bounds extend half a node past every edge, so an object is stored at the deepest level whose nodes are at least its size,
+	// in the node containing its centre. Levels are stored sparsely (only occupied nodes exist) and queries visit the nodes each level overlaps
+	// Objects centred outside of the tree's bounds are kept in a separate list that every query checks
+	class LooseQuadTree : public SpatialIndex
+	{
+	public:
+		explicit LooseQuadTree( const sf::FloatRect& bounds, const unsigned maxDepth = 8 );
+
+		void Insert( const Object& object ) override;
+		void Remove( const Object& object ) override;
+
+		unsigned GetMaxDepth() const { return m_maxDepth; }
+		sf::FloatRect GetBounds() const { return sf::FloatRect( m_origin, sf::Vector2f( m_size, m_size ) ); }
+
+	protected:
+		void ForEachCandidate( const sf::FloatRect& boundary, const CandidateCallback& callback ) const override;
+		SpatialIndexLocation Locate( const Object& object ) const override;
+		void Relocate( const Object& object, const SpatialIndexLocation& newLocation ) override;
+		void Clear() override;
+
+		SpatialIndexLocation Locate( const sf::FloatRect& bounds ) const;
+		void InsertAt( const Object& object, const SpatialIndexLocation& location );
+		void RemoveAt( const Object& object, const SpatialIndexLocation& location );
+		float GetNodeSize( const unsigned level ) const { return m_size / float( 1U << level ); }
+
+		static std::uint64_t NodeKey( const sf::Vector2i& node );
+
+	private:
+		// Location id used for objects outside of the tree's bounds
+		static constexpr std::uint32_t OutsideLevel = std::numeric_limits< std::uint32_t >::max();
+
+		sf::Vector2f m_origin;
+		float m_size = 0.0f;
+		unsigned m_maxDepth = 0U;
+
+		typedef std::unordered_map< std::uint64_t, std::vector< BaseObject > > Level;
+		std::vector< Level > m_levels;
+		std::vector< BaseObject > m_outside;
+	};
+}
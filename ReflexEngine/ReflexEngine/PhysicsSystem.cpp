@@ -5,20 +5,67 @@
 
 namespace Reflex::Systems
 {
+	namespace
+	{
+		// Matches sf::Transformable::setRotation, so an unchanged angle compares equal to the transform's rotation
+		float NormaliseRotation( const float degrees )
+		{
+			const auto rotation = ( float )std::fmod( degrees, 360.0 );
+			return rotation < 0.0f ? rotation + 360.0f : rotation;
+		}
+	}
+
 	void PhysicsSystem::RegisterComponents()
 	{
 		RequiresComponent( Reflex::Components::RigidBody );
+		ReadsComponent( Reflex::Components::RigidBody );
+		WritesComponent( Reflex::Components::Transform );
 	}
 
 	void PhysicsSystem::Update( const float deltaTime )
 	{
-		for( const auto& object : m_releventObjects )
+		PROFILE;
+		m_awakeBodies.clear();
+
+		// Bodies without an owning object were created directly on the b2World rather than through a RigidBody
+		for( auto* body = GetWorld().GetBox2DWorld().GetBodyList(); body; body = body->GetNext() )
 		{
-			if( const auto rigidBody = object.GetComponent< Reflex::Components::RigidBody >() )
+			if( body->GetType() == b2_staticBody || !body->IsAwake() || !body->GetUserData() )
+				continue;
+
+			auto& sync = m_awakeBodies.emplace_back();
+			sync.body = body;
+			sync.object = *static_cast< const Reflex::Object* >( body->GetUserData() );
+		}
+
+		// Reading the new positions and comparing against the transforms doesn't write anything, so is split across the job system
+		GetWorld().GetJobSystem().ParallelFor( m_awakeBodies.size(), 256, [&]( const std::size_t begin, const std::size_t end )
+		{
+			for( auto i = begin; i < end; ++i )
 			{
-				object.GetTransform()->setPosition( rigidBody->GetPosition() );
-				object.GetTransform()->setRotation( rigidBody->GetRotation() );
+				auto& sync = m_awakeBodies[i];
+				sync.transform = sync.object.GetTransform().Get();
+				sync.position = Reflex::B2VecToVector2f( sync.body->GetPosition() );
+				sync.rotation = NormaliseRotation( Reflex::ToWorldUnits( sync.body->GetAngle() ) );
+				sync.moved = sync.position != sync.transform->getPosition() || sync.rotation != sync.transform->getRotation();
 			}
+		} );
+
+		auto& spatialIndex = GetWorld().GetSpatialIndex();
+
+		for( const auto& sync : m_awakeBodies )
+		{
+			if( !sync.moved )
+				continue;
+
+			// Written directly rather than through Transform::setPosition, the spatial index is only told about bodies that changed location
+			sync.transform->Core::SceneNode::setPosition( sync.position );
+			sync.transform->setRotation( sync.rotation );
+
+#ifndef DISABLE_TILEMAP
+			if( sync.transform->UsesTileMap() && spatialIndex.IsRelocated( sync.object ) )
+				spatialIndex.Move( sync.object );
+#endif
 		}
 	}
 }
\ No newline at end of file
@@ -2,8 +2,14 @@
 
 #include "System.h"
 
+class b2Body;
+
+namespace Reflex::Components { class Transform; }
+
 namespace Reflex::Systems
 {
+	// Copies rigid body positions onto transforms after the Box2D step
+	// Only awake bodies are visited (walking Box2D's body list), so sleeping and static bodies cost nothing beyond the list walk
 	class PhysicsSystem : public System
 	{
 	public:
@@ -11,5 +17,19 @@ namespace Reflex::Systems
 
 		void RegisterComponents() final;
 		void Update( const float deltaTime ) final;
+
+	protected:
+		struct BodySync
+		{
+			b2Body* body = nullptr;
+			Reflex::Object object;
+			Reflex::Components::Transform* transform = nullptr;
+			sf::Vector2f position;
+			float rotation = 0.0f;
+			bool moved = false;
+		};
+
+		// Reused between updates to avoid reallocating
+		std::vector< BodySync > m_awakeBodies;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "Precompiled.h"
+#include "Prefab.h"
+#include "BinaryStream.h"
+#include "Logging.h"
+
+namespace Reflex::Core
+{
+	namespace
+	{
+		constexpr std::uint32_t PrefabMagic = 0x424F5246; // "FROB"
+		constexpr std::uint32_t PrefabVersion = 2U;
+		// Values were stored as strings
+		constexpr std::uint32_t PrefabStringValuesVersion = 1U;
+
+		Prefab::Component& AddComponent( Prefab& prefab, const std::string& name, const PrefabComponentResolver& resolver, FieldTable& fields )
+		{
+			auto& component = prefab.components.emplace_back();
+			component.name = name;
+
+			if( !resolver( name, component.family, fields ) )
+				THROW( "Invalid component name in file: " << prefab.file << " , component: " << name );
+
+			return component;
+		}
+
+		const Field& FindField( const Prefab& prefab, const Prefab::Component& component, const FieldTable& fields, const std::string& variable )
+		{
+			const auto* field = fields.Find( variable );
+
+			if( !field )
+				THROW( "Invalid component variable name in file: " << prefab.file << " , component: " << component.name << ", variable: " << variable );
+
+			return *field;
+		}
+	}
+
+	Prefab ReadPrefabJson( const std::string& file, const PrefabComponentResolver& resolver )
+	{
+		std::ifstream input( file );
+
+		if( input.fail() )
+			THROW( "Invalid object file name: " << file );
+
+		Json::CharReaderBuilder reader;
+		Json::Value obj;
+		std::string errs;
+
+		if( !Json::parseFromStream( reader, input, &obj, &errs ) )
+			THROW( "Invalid object file data: " << file );
+
+		Prefab prefab;
+		prefab.file = file;
+
+		const auto& components = obj["Components"];
+
+		for( const auto& componentName : components.getMemberNames() )
+		{
+			FieldTable fields;
+			auto& component = AddComponent( prefab, componentName, resolver, fields );
+
+			const auto& componentData = components[componentName];
+
+			for( const auto& variable : componentData.getMemberNames() )
+			{
+				const auto& field = FindField( prefab, component, fields, variable );
+				component.values.push_back( { &field, FieldValueFromJson( componentData[variable], field.type ) } );
+			}
+		}
+
+		return prefab;
+	}
+
+	Prefab ReadPrefabBinary( const std::string& file, const PrefabComponentResolver& resolver )
+	{
+		const MappedFile mappedFile( file );
+		BinaryReader reader( mappedFile, file );
+
+		if( reader.ReadUInt() != PrefabMagic )
+			THROW( "Invalid object file data: " << file );
+
+		const auto version = reader.ReadUInt();
+		if( version != PrefabVersion && version != PrefabStringValuesVersion )
+			THROW( "Unsupported object file version: " << file << ", version: " << version );
+
+		Prefab prefab;
+		prefab.file = file;
+
+		const auto componentCount = reader.ReadUInt();
+		prefab.components.reserve( componentCount );
+
+		for( std::uint32_t i = 0; i < componentCount; ++i )
+		{
+			FieldTable fields;
+			auto& component = AddComponent( prefab, reader.ReadString(), resolver, fields );
+			component.values.resize( reader.ReadUInt() );
+
+			for( auto& value : component.values )
+			{
+				const auto& field = FindField( prefab, component, fields, reader.ReadString() );
+				value.field = &field;
+
+				if( version == PrefabStringValuesVersion )
+				{
+					value.value = FieldValueFromString( reader.ReadString(), field.type );
+					continue;
+				}
+
+				const auto type = ( FieldType )reader.ReadValue< std::uint8_t >();
+				if( type != field.type )
+					THROW( "Mismatched variable type in file: " << file << " , component: " << component.name << ", variable: " << field.name );
+
+				value.value = reader.ReadFieldValue( type );
+			}
+		}
+
+		return prefab;
+	}
+
+	void WritePrefabBinary( const Prefab& prefab, const std::string& file )
+	{
+		BinaryWriter writer( file );
+
+		writer.WriteUInt( PrefabMagic );
+		writer.WriteUInt( PrefabVersion );
+		writer.WriteUInt( ( std::uint32_t )prefab.components.size() );
+
+		for( const auto& component : prefab.components )
+		{
+			writer.WriteString( component.name );
+			writer.WriteUInt( ( std::uint32_t )component.values.size() );
+
+			for( const auto& value : component.values )
+			{
+				writer.WriteString( value.field->name );
+				writer.WriteValue( ( std::uint8_t )value.field->type );
+				writer.WriteFieldValue( value.value );
+			}
+		}
+	}
+}
\ No newline at end of file
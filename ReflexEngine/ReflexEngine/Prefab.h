@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Reflection.h"
+
+namespace Reflex::Core
+{
+	// Parsed contents of an object file, cached by World::GetPrefab so spawning from a file doesn't touch the disk or the json parser
+	// Loaded from json (.ro) or the compiled binary format (.rob, see WritePrefabBinary)
+	// Values are resolved to their component's fields and converted to the field's type while loading, so instantiating is a direct write per value
+	struct Prefab
+	{
+		struct Value
+		{
+			const Field* field = nullptr;
+			FieldValue value;
+		};
+
+		struct Component
+		{
+			std::string name;
+			std::size_t family = 0U;
+			std::vector< Value > values;
+		};
+
+		std::string file;
+		std::vector< Component > components;
+	};
+
+	// Looks up a component by name, returning false if there is no such component
+	typedef std::function< bool( const std::string& name, std::size_t& family, FieldTable& fields ) > PrefabComponentResolver;
+
+	Prefab ReadPrefabJson( const std::string& file, const PrefabComponentResolver& resolver );
+	Prefab ReadPrefabBinary( const std::string& file, const PrefabComponentResolver& resolver );
+
+	// .rob layout: magic, version, component count, then per component its name, value count and values
+	// Each value is its field name, field type and then the raw value (strings are a 32 bit length followed by the characters, version 1 files stored every value as a string)
+	void WritePrefabBinary( const Prefab& prefab, const std::string& file );
+}
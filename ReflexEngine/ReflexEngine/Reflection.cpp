@@ -0,0 +1,136 @@
+#include "Precompiled.h"
+#include "Reflection.h"
+#include "Logging.h"
+
+namespace Reflex::Core
+{
+	namespace
+	{
+		// Vectors, colours and points are stored as flat arrays of numbers
+		FieldValue FieldValueFromNumbers( const std::vector< double >& numbers, const FieldType type )
+		{
+			const auto get = [&]( const std::size_t index, const double fallback = 0.0 )
+			{
+				return index < numbers.size() ? numbers[index] : fallback;
+			};
+
+			switch( type )
+			{
+			case FieldType::Bool: return get( 0 ) != 0.0;
+			case FieldType::Int: return ( int )get( 0 );
+			case FieldType::Unsigned: return ( unsigned )get( 0 );
+			case FieldType::Float: return ( float )get( 0 );
+			case FieldType::Vector2f: return sf::Vector2f( ( float )get( 0 ), ( float )get( 1 ) );
+			case FieldType::Vector2u: return sf::Vector2u( ( unsigned )get( 0 ), ( unsigned )get( 1 ) );
+			case FieldType::Colour: return sf::Color( ( sf::Uint8 )get( 0 ), ( sf::Uint8 )get( 1 ), ( sf::Uint8 )get( 2 ), ( sf::Uint8 )get( 3, 255.0 ) );
+			case FieldType::Points:
+			{
+				std::vector< sf::Vector2f > points( numbers.size() / 2 );
+				for( std::size_t i = 0; i < points.size(); ++i )
+					points[i] = sf::Vector2f( ( float )numbers[i * 2], ( float )numbers[i * 2 + 1] );
+				return points;
+			}
+			default: THROW( "Invalid field type: " << ( int )type );
+			}
+		}
+
+		void AppendJsonNumbers( const Json::Value& value, std::vector< double >& numbers )
+		{
+			if( value.isArray() )
+			{
+				for( const auto& element : value )
+					AppendJsonNumbers( element, numbers );
+			}
+			else if( value.isBool() )
+				numbers.push_back( value.asBool() ? 1.0 : 0.0 );
+			else
+				numbers.push_back( value.asDouble() );
+		}
+
+		Json::Value JsonArray( std::initializer_list< Json::Value > values )
+		{
+			Json::Value array( Json::arrayValue );
+			for( const auto& value : values )
+				array.append( value );
+			return array;
+		}
+	}
+
+	const Field* FieldTable::Find( const std::string& name ) const
+	{
+		const auto found = std::find_if( begin(), end(), [&]( const Field& field )
+		{
+			return name == field.name;
+		} );
+
+		return found == end() ? nullptr : found;
+	}
+
+	Json::Value FieldValueToJson( const FieldValue& value )
+	{
+		switch( ( FieldType )value.index() )
+		{
+		case FieldType::Bool: return std::get< bool >( value );
+		case FieldType::Int: return std::get< int >( value );
+		case FieldType::Unsigned: return std::get< unsigned >( value );
+		case FieldType::Float: return std::get< float >( value );
+		case FieldType::Vector2f:
+		{
+			const auto& vec = std::get< sf::Vector2f >( value );
+			return JsonArray( { vec.x, vec.y } );
+		}
+		case FieldType::Vector2u:
+		{
+			const auto& vec = std::get< sf::Vector2u >( value );
+			return JsonArray( { vec.x, vec.y } );
+		}
+		case FieldType::Colour:
+		{
+			const auto& colour = std::get< sf::Color >( value );
+			return JsonArray( { colour.r, colour.g, colour.b, colour.a } );
+		}
+		case FieldType::String: return std::get< std::string >( value );
+		case FieldType::Points:
+		{
+			Json::Value points( Json::arrayValue );
+			for( const auto& point : std::get< std::vector< sf::Vector2f > >( value ) )
+				points.append( JsonArray( { point.x, point.y } ) );
+			return points;
+		}
+		default: THROW( "Invalid field type: " << value.index() );
+		}
+	}
+
+	FieldValue FieldValueFromJson( const Json::Value& value, const FieldType type )
+	{
+		if( type == FieldType::String )
+			return value.asString();
+
+		if( value.isString() )
+			return FieldValueFromString( value.asString(), type );
+
+		std::vector< double > numbers;
+		AppendJsonNumbers( value, numbers );
+		return FieldValueFromNumbers( numbers, type );
+	}
+
+	FieldValue FieldValueFromString( const std::string& value, const FieldType type )
+	{
+		if( type == FieldType::String )
+			return value;
+
+		if( type == FieldType::Bool && ( value == "true" || value == "false" ) )
+			return value == "true";
+
+		// Comma separated numbers, eg. "12, 34"
+		auto text = value;
+		std::replace( text.begin(), text.end(), ',', ' ' );
+
+		std::vector< double > numbers;
+		std::stringstream stream( text );
+		for( double number = 0.0; stream >> number; )
+			numbers.push_back( number );
+
+		return FieldValueFromNumbers( numbers, type );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Precompiled.h"
+#include <variant>
+
+namespace Reflex::Components { class BaseComponent; }
+
+namespace Reflex::Core
+{
+	// Types a serialised component field can have, in the same order as the FieldValue alternatives
+	enum class FieldType : std::uint8_t
+	{
+		Bool,
+		Int,
+		Unsigned,
+		Float,
+		Vector2f,
+		Vector2u,
+		Colour,
+		String,
+		Points,
+		NumTypes,
+	};
+
+	typedef std::variant< bool, int, unsigned, float, sf::Vector2f, sf::Vector2u, sf::Color, std::string, std::vector< sf::Vector2f > > FieldValue;
+
+	// A serialised field of a component, components list theirs in a static GetFields table (see the Reflect macros in Component.h)
+	// Values are read / written directly through these accessors, plain members go through a member pointer and properties through the component's getters / setters
+	struct Field
+	{
+		typedef FieldValue( *Getter )( const Reflex::Components::BaseComponent& component );
+		typedef void( *Setter )( Reflex::Components::BaseComponent& component, const FieldValue& value );
+		typedef bool( *Predicate )( const Reflex::Components::BaseComponent& component );
+
+		const char* name = nullptr;
+		FieldType type = FieldType::NumTypes;
+		Getter get = nullptr;
+		Setter set = nullptr;
+		// Optional, the field is only saved when this returns true (eg. flags that aren't set)
+		Predicate shouldSave = nullptr;
+
+		bool ShouldSave( const Reflex::Components::BaseComponent& component ) const { return !shouldSave || shouldSave( component ); }
+	};
+
+	// View of a component's static field array
+	class FieldTable
+	{
+	public:
+		FieldTable() = default;
+
+		template< std::size_t N >
+		constexpr FieldTable( const Field( &fields )[N] ) : m_fields( fields ), m_count( N ) { }
+
+		const Field* begin() const { return m_fields; }
+		const Field* end() const { return m_fields + m_count; }
+		std::size_t size() const { return m_count; }
+		bool empty() const { return m_count == 0; }
+
+		const Field* Find( const std::string& name ) const;
+
+	private:
+		const Field* m_fields = nullptr;
+		std::size_t m_count = 0;
+	};
+
+	template< typename T >
+	constexpr FieldType GetFieldType();
+
+	template< auto Member >
+	constexpr Field MakeMemberField( const char* name, const Field::Predicate shouldSave = nullptr );
+
+	// Conversions used by the text formats (.ro files), the old comma separated string values are still accepted when reading
+	Json::Value FieldValueToJson( const FieldValue& value );
+	FieldValue FieldValueFromJson( const Json::Value& value, const FieldType type );
+	FieldValue FieldValueFromString( const std::string& value, const FieldType type );
+
+	// Template definitions
+	namespace Detail
+	{
+		template< typename T, std::size_t I = 0 >
+		constexpr std::size_t FieldValueIndex()
+		{
+			static_assert( I < std::variant_size_v< FieldValue >, "Type can't be used as a component field" );
+
+			if constexpr( std::is_same_v< std::variant_alternative_t< I, FieldValue >, T > )
+				return I;
+			else
+				return FieldValueIndex< T, I + 1 >();
+		}
+
+		template< typename T >
+		struct MemberPointer;
+
+		template< typename C, typename M >
+		struct MemberPointer< M C::* >
+		{
+			typedef C Class;
+			typedef M Type;
+		};
+	}
+
+	template< typename T >
+	constexpr FieldType GetFieldType()
+	{
+		return ( FieldType )Detail::FieldValueIndex< T >();
+	}
+
+	template< auto Member >
+	constexpr Field MakeMemberField( const char* name, const Field::Predicate shouldSave )
+	{
+		typedef typename Detail::MemberPointer< decltype( Member ) >::Class Class;
+		typedef typename Detail::MemberPointer< decltype( Member ) >::Type Type;
+
+		return Field
+		{
+			name,
+			GetFieldType< Type >(),
+			[]( const Reflex::Components::BaseComponent& component ) -> FieldValue { return static_cast< const Class& >( component ).*Member; },
+			[]( Reflex::Components::BaseComponent& component, const FieldValue& value ) { static_cast< Class& >( component ).*Member = std::get< Type >( value ); },
+			shouldSave,
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "Precompiled.h"
+#include "RenderBatch.h"
+
+namespace Reflex::Core
+{
+	RenderBatch::RenderBatch( sf::RenderTarget& target, const sf::RenderStates& states, sf::VertexArray& vertices )
+		: m_target( target )
+		, m_states( states )
+		, m_vertices( vertices )
+	{
+		m_vertices.clear();
+		m_vertices.setPrimitiveType( sf::Triangles );
+	}
+
+	sf::Vertex* RenderBatch::Allocate( const sf::Texture* texture, const std::size_t vertexCount )
+	{
+		if( texture != m_texture )
+		{
+			Flush();
+			m_texture = texture;
+		}
+
+		const auto start = m_vertices.getVertexCount();
+		m_vertices.resize( start + vertexCount );
+		m_vertexCount += vertexCount;
+		return &m_vertices[start];
+	}
+
+	void RenderBatch::Flush()
+	{
+		if( m_vertices.getVertexCount() == 0 )
+			return;
+
+		auto states = m_states;
+		states.texture = m_texture;
+		m_target.draw( m_vertices, states );
+		m_vertices.clear();
+		++m_drawCalls;
+	}
+
+	void RenderBatch::BeginIndividualDraw()
+	{
+		Flush();
+		++m_drawCalls;
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Precompiled.h"
+
+namespace Reflex::Core
+{
+	// Collects triangles from consecutive render components that share a texture into one vertex array, so they are submitted as a single draw call
+	// Vertices are only ever appended in render order, a texture change (or an individually drawn component) submits the pending vertices first
+	class RenderBatch : private sf::NonCopyable
+	{
+	public:
+		// The vertex array is owned by the caller so its allocation is reused between frames
+		RenderBatch( sf::RenderTarget& target, const sf::RenderStates& states, sf::VertexArray& vertices );
+
+		// Returns space for vertexCount triangle vertices drawn with texture (which can be null), submitting the pending vertices first if they use a different texture
+		sf::Vertex* Allocate( const sf::Texture* texture, const std::size_t vertexCount );
+
+		// Submits any pending vertices as one draw call
+		void Flush();
+
+		// Called before a component that can't be batched draws itself, submits the pending vertices so the render order is kept
+		void BeginIndividualDraw();
+
+		unsigned GetDrawCalls() const { return m_drawCalls; }
+		std::size_t GetVertexCount() const { return m_vertexCount; }
+
+	private:
+		sf::RenderTarget& m_target;
+		sf::RenderStates m_states;
+		sf::VertexArray& m_vertices;
+		const sf::Texture* m_texture = nullptr;
+
+		unsigned m_drawCalls = 0U;
+		std::size_t m_vertexCount = 0U;
+	};
+}
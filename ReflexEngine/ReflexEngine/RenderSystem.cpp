@@ -3,42 +3,98 @@
 #include "RenderSystem.h"
 #include "SFMLObjectComponent.h"
 #include "TransformComponent.h"
+#include "RenderBatch.h"
 
 namespace Reflex::Systems
 {
 	bool RenderSystem::ShouldAddObject( const Object& object ) const
 	{
+		bool result = false;
+
 		for( unsigned i = 0; i < Reflex::MaxComponents; ++i )
+		{
 			if( const auto* cmp = GetWorld().ObjectGetComponent( object, i ) )
+			{
 				if( cmp->IsRenderComponent() )
-					return true;
+				{
+					m_renderComponents.set( i );
+					result = true;
+				}
+			}
+		}
 
-		return false;
+		return result;
 	}
 
 	void RenderSystem::AddComponent( const Object& object )
 	{
-		m_releventObjects.insert( GetInsertionIndex( object ), object );
+		m_orderDirty = true;
+	}
+
+	void RenderSystem::OnComponentRemoved( const Reflex::Object& object )
+	{
+		m_orderDirty = true;
 	}
 
-	std::vector< Reflex::Object >::const_iterator RenderSystem::GetInsertionIndex( const Object& object ) const
+	void RenderSystem::OnSystemStartup()
 	{
-		return std::lower_bound( m_releventObjects.begin(), m_releventObjects.end(), object, []( const Reflex::Object& left, const Reflex::Object& right )
+		GetWorld().GetEventManager().SubscribeBatch< Components::Transform::RenderIndexChangedEvent >( *this, &RenderSystem::OnRenderIndicesChanged );
+	}
+
+	void RenderSystem::OnRenderIndicesChanged( const std::vector< Components::Transform::RenderIndexChangedEvent >& events )
+	{
+		m_orderDirty = m_orderDirty || std::any_of( events.begin(), events.end(), [&]( const Components::Transform::RenderIndexChangedEvent& e )
 		{
-			return left.GetTransform()->GetRenderIndex() < right.GetTransform()->GetRenderIndex();
+			return HasObject( e.object );
 		} );
 	}
 
-	void RenderSystem::OnComponentAdded( const Reflex::Object& object )
+	const std::vector< Reflex::Object >& RenderSystem::GetRenderOrder() const
 	{
-		object.GetTransform()->Subscribe< Components::Transform::RenderIndexChangedEvent >( *this, &RenderSystem::OnRenderIndexChanged );
+		if( !m_orderDirty )
+			return m_renderOrder;
+
+		PROFILE;
+		m_orderDirty = false;
+
+		// Keys are the render index in the high bits and the object's position in the low bits, so equal render indices keep their relative order in the object list
+		m_sortKeys.resize( m_releventObjects.size() );
+		for( std::size_t i = 0; i < m_releventObjects.size(); ++i )
+			m_sortKeys[i] = ( std::uint64_t( m_releventObjects[i].GetTransform()->GetRenderIndex() ) << 32 ) | std::uint64_t( i );
+
+		RadixSortRenderIndices( m_sortKeys, m_sortScratch );
+
+		m_renderOrder.clear();
+		m_renderOrder.reserve( m_sortKeys.size() );
+		for( const auto key : m_sortKeys )
+			m_renderOrder.push_back( m_releventObjects[key & 0xFFFFFFFF] );
+
+		return m_renderOrder;
 	}
 
-	void RenderSystem::OnRenderIndexChanged( const Components::Transform::RenderIndexChangedEvent& e )
+	void RenderSystem::RadixSortRenderIndices( std::vector< std::uint64_t >& keys, std::vector< std::uint64_t >& scratch )
 	{
-		m_releventObjects.erase( Reflex::Find( m_releventObjects, e.object ) );
-		const auto newPos = GetInsertionIndex( e.object );
-		m_releventObjects.insert( newPos, e.object );
+		// LSD radix sort on the 32 render index bits, 8 bits per pass. Passes where every key has the same digit are skipped (usually the high bytes)
+		scratch.resize( keys.size() );
+
+		for( unsigned shift = 32; shift < 64; shift += 8 )
+		{
+			std::array< std::size_t, 257 > offsets{};
+
+			for( const auto key : keys )
+				++offsets[( ( key >> shift ) & 0xFF ) + 1];
+
+			if( std::any_of( offsets.begin() + 1, offsets.end(), [&]( const std::size_t count ) { return count == keys.size(); } ) )
+				continue;
+
+			for( unsigned digit = 1; digit < offsets.size(); ++digit )
+				offsets[digit] += offsets[digit - 1];
+
+			for( const auto key : keys )
+				scratch[offsets[( key >> shift ) & 0xFF]++] = key;
+
+			std::swap( keys, scratch );
+		}
 	}
 
 	void RenderSystem::Render( sf::RenderTarget& target, sf::RenderStates states ) const
@@ -46,18 +102,35 @@ namespace Reflex::Systems
 		PROFILE;
 		sf::RenderStates copied_states( states );
 
-		for( const auto& object : m_releventObjects )
+		// Batched vertices are already in world space
+		copied_states.transform = sf::Transform::Identity;
+		Reflex::Core::RenderBatch batch( target, copied_states, m_batchVertices );
+
+		for( const auto& object : GetRenderOrder() )
 		{
+			const auto renderComponents = GetWorld().ObjectGetComponentFlags( object ) & m_renderComponents;
+			if( renderComponents.none() )
+				continue;
+
+			const auto worldTransform = object.GetTransform()->GetWorldTransform();
+
 			for( unsigned i = 0; i < Reflex::MaxComponents; ++i )
 			{
+				if( !renderComponents.test( i ) )
+					continue;
+
 				const auto* cmp = GetWorld().ObjectGetComponent( object, i );
 
-				if( !cmp || !cmp->IsRenderComponent() )
+				if( cmp->Batch( batch, worldTransform ) )
 					continue;
 
-				copied_states.transform = object.GetTransform()->GetWorldTransform();
+				batch.BeginIndividualDraw();
+				copied_states.transform = worldTransform;
 				cmp->Render( target, copied_states );
 			}
 		}
+
+		batch.Flush();
+		m_lastFrameStats = RenderStats{ batch.GetDrawCalls(), batch.GetVertexCount() };
 	}
 }
\ No newline at end of file
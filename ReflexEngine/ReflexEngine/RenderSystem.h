@@ -5,6 +5,14 @@
 
 namespace Reflex::Systems
 {
+	struct RenderStats
+	{
+		unsigned drawCalls = 0U;
+		std::size_t vertices = 0U;
+	};
+
+	// Renders objects in render index order, consecutive components sharing a texture are batched into a single draw call (see RenderBatch)
+	// Adding objects and changing render indices only flag the order as dirty, it is rebuilt with a radix sort the next time it is needed
 	class RenderSystem : public System, public EventReceiver
 	{
 	public:
@@ -13,18 +21,35 @@ namespace Reflex::Systems
 		void RegisterComponents() final { }
 		bool ShouldAddObject( const Object& object ) const final;
 		void AddComponent( const Object& object ) final;
-		void OnComponentAdded( const Reflex::Object& object ) final;
+		void OnComponentRemoved( const Reflex::Object& object ) final;
 
 		void Render( sf::RenderTarget& target, sf::RenderStates states ) const final;
-		void OnSystemStartup() final {}
+		void OnSystemStartup() final;
 		void OnSystemShutdown() final { }
 
-		// Transform event callback
-		void OnRenderIndexChanged( const Components::Transform::RenderIndexChangedEvent& e );
+		// Transform event callback, render index changes are queued and handled together when the event queues are flushed
+		void OnRenderIndicesChanged( const std::vector< Components::Transform::RenderIndexChangedEvent >& events );
+
+		// Objects sorted by render index, equal render indices keep their relative order in the object list (see System::EraseObject)
+		const std::vector< Reflex::Object >& GetRenderOrder() const;
 
-		std::vector< Reflex::Object >::const_iterator GetInsertionIndex( const Object& object ) const;
+		// Draw calls and batched vertices submitted by the last Render
+		const RenderStats& GetLastFrameStats() const { return m_lastFrameStats; }
 
 	protected:
-		std::vector< Reflex::ComponentFamily > m_objectRenderComponents;
+		static void RadixSortRenderIndices( std::vector< std::uint64_t >& keys, std::vector< std::uint64_t >& scratch );
+
+	protected:
+		// Component families found to be render components, so Render only fetches those components
+		mutable Reflex::ComponentsMask m_renderComponents;
+
+		// Reused between frames so the batch doesn't reallocate
+		mutable sf::VertexArray m_batchVertices;
+		mutable RenderStats m_lastFrameStats;
+
+		mutable std::vector< Reflex::Object > m_renderOrder;
+		mutable std::vector< std::uint64_t > m_sortKeys;
+		mutable std::vector< std::uint64_t > m_sortScratch;
+		mutable bool m_orderDirty = false;
 	};
 }
\ No newline at end of file
@@ -2,9 +2,51 @@
 #include "SFMLObjectComponent.h"
 #include "Object.h"
 #include "ColliderComponent.h"
+#include "RenderBatch.h"
 
 namespace Reflex::Components
 {
+	namespace
+	{
+		// Fills a shape as a triangle fan around the centre of its points (as sf::Shape does), outlines aren't batched
+		bool BatchShape( const sf::Shape& shape, Reflex::Core::RenderBatch& batch, const sf::Transform& transform )
+		{
+			if( shape.getOutlineThickness() != 0.0f )
+				return false;
+
+			const auto pointCount = shape.getPointCount();
+			if( pointCount < 3 )
+				return true;
+
+			const auto finalTransform = transform * shape.getTransform();
+			const auto bounds = shape.getLocalBounds();
+			const auto textureRect = sf::FloatRect( shape.getTextureRect() );
+			const auto colour = shape.getFillColor();
+
+			const auto makeVertex = [&]( const sf::Vector2f& point )
+			{
+				const auto u = bounds.width > 0.0f ? ( point.x - bounds.left ) / bounds.width : 0.0f;
+				const auto v = bounds.height > 0.0f ? ( point.y - bounds.top ) / bounds.height : 0.0f;
+				return sf::Vertex( finalTransform.transformPoint( point ), colour, sf::Vector2f( textureRect.left + textureRect.width * u, textureRect.top + textureRect.height * v ) );
+			};
+
+			const auto centre = makeVertex( sf::Vector2f( bounds.left + bounds.width / 2.0f, bounds.top + bounds.height / 2.0f ) );
+			auto* vertices = batch.Allocate( shape.getTexture(), pointCount * 3 );
+			auto previous = makeVertex( shape.getPoint( pointCount - 1 ) );
+
+			for( std::size_t i = 0; i < pointCount; ++i )
+			{
+				const auto current = makeVertex( shape.getPoint( i ) );
+				*vertices++ = centre;
+				*vertices++ = previous;
+				*vertices++ = current;
+				previous = current;
+			}
+
+			return true;
+		}
+	}
+
 	CircleShape::CircleShape( const Reflex::Object& owner, const float radius, const std::size_t pointCount, const std::optional< sf::Color > colour )
 		: Component< CircleShape >( owner )
 		, sf::CircleShape( radius, pointCount )
@@ -111,63 +153,133 @@ namespace Reflex::Components
 			setFillColor( *colour );
 	}
 
-	TODO( "SFML object set values (deserialisation" );
-	bool CircleShape::SetValue( const std::string& variable, const std::string& value )
+// Fields shared by the sf::Shape based components, the origin is re-centred when the geometry changes (as the constructors do)
+#define ReflectShapeColours( Class ) \
+	ReflectPropertyIf( Class, "FillColour", sf::Color, component.getFillColor(), component.setFillColor( value ), !Reflex::IsDefault( component.getFillColor() ) ), \
+	ReflectPropertyIf( Class, "OutlineColour", sf::Color, component.getOutlineColor(), component.setOutlineColor( value ), !Reflex::IsDefault( component.getOutlineColor() ) ), \
+	ReflectPropertyIf( Class, "OutlineThickness", float, component.getOutlineThickness(), component.setOutlineThickness( value ), component.getOutlineThickness() != 0.0f )
+
+	Reflex::Core::FieldTable CircleShape::GetFields()
+	{
+		static constexpr Reflex::Core::Field fields[] =
+		{
+			ReflectProperty( CircleShape, "Radius", float, component.getRadius(), component.setRadius( value ); Reflex::CenterOrigin( component ) ),
+			ReflectProperty( CircleShape, "PointCount", unsigned, component.getPointCount(), component.setPointCount( value ); Reflex::CenterOrigin( component ) ),
+			ReflectShapeColours( CircleShape ),
+		};
+
+		return fields;
+	}
+
+	Reflex::Core::FieldTable RectangleShape::GetFields()
 	{
-		return false;
+		static constexpr Reflex::Core::Field fields[] =
+		{
+			ReflectProperty( RectangleShape, "Size", sf::Vector2f, component.getSize(), component.setSize( value ); Reflex::CenterOrigin( component ) ),
+			ReflectShapeColours( RectangleShape ),
+		};
+
+		return fields;
 	}
 
-	bool RectangleShape::SetValue( const std::string& variable, const std::string& value )
+	Reflex::Core::FieldTable ConvexShape::GetFields()
 	{
-		return false;
+		static constexpr Reflex::Core::Field fields[] =
+		{
+			ReflectProperty( ConvexShape, "Points", std::vector< sf::Vector2f >, component.GetPoints(), component.SetPoints( value ) ),
+			ReflectShapeColours( ConvexShape ),
+		};
+
+		return fields;
 	}
 
-	bool ConvexShape::SetValue( const std::string& variable, const std::string& value )
+	Reflex::Core::FieldTable Sprite::GetFields()
 	{
-		return false;
+		TODO( "Serialise sprite texture somehow" );
+		static constexpr Reflex::Core::Field fields[] =
+		{
+			ReflectPropertyIf( Sprite, "Colour", sf::Color, component.getColor(), component.setColor( value ), !Reflex::IsDefault( component.getColor() ) ),
+		};
+
+		return fields;
 	}
 
-	bool Sprite::SetValue( const std::string& variable, const std::string& value )
+	Reflex::Core::FieldTable Text::GetFields()
 	{
-		return false;
+		static constexpr Reflex::Core::Field fields[] =
+		{
+			ReflectProperty( Text, "String", std::string, component.getString().toAnsiString(), component.setString( value ); Reflex::CenterOrigin( component ) ),
+			ReflectProperty( Text, "Style", unsigned, component.getStyle(), component.setStyle( value ) ),
+			ReflectProperty( Text, "CharacterSize", unsigned, component.getCharacterSize(), component.setCharacterSize( value ); Reflex::CenterOrigin( component ) ),
+			ReflectPropertyIf( Text, "FillColour", sf::Color, component.getFillColor(), component.setFillColor( value ), !Reflex::IsDefault( component.getFillColor() ) ),
+			ReflectPropertyIf( Text, "OutlineColour", sf::Color, component.getOutlineColor(), component.setOutlineColor( value ), !Reflex::IsDefault( component.getOutlineColor() ) ),
+		};
+
+		return fields;
 	}
 
-	bool Text::SetValue( const std::string& variable, const std::string& value )
+#undef ReflectShapeColours
+
+	std::vector< sf::Vector2f > ConvexShape::GetPoints() const
 	{
-		return false;
+		std::vector< sf::Vector2f > points( getPointCount() );
+		for( size_t i = 0; i < points.size(); ++i )
+			points[i] = getPoint( i );
+		return points;
 	}
 
-	void CircleShape::GetValues( std::vector< std::pair< std::string, std::string > >& values ) const
+	void ConvexShape::SetPoints( const std::vector< sf::Vector2f >& points )
 	{
-		values.emplace_back( "Radius", Reflex::ToString( getRadius() ) );
-		GetShapeValues( values, *this);
-		GetColourValues( values, *this );
+		setPointCount( points.size() );
+		for( size_t i = 0; i < points.size(); ++i )
+			setPoint( i, points[i] );
+		Reflex::CenterOrigin( *this );
 	}
 
-	void RectangleShape::GetValues( std::vector< std::pair< std::string, std::string > >& values ) const
+	bool CircleShape::Batch( Reflex::Core::RenderBatch& batch, const sf::Transform& transform ) const
 	{
-		GetShapeValues( values, *this );
-		GetColourValues( values, *this );
+		return BatchShape( *this, batch, transform );
 	}
 
-	void ConvexShape::GetValues( std::vector< std::pair< std::string, std::string > >& values ) const
+	bool RectangleShape::Batch( Reflex::Core::RenderBatch& batch, const sf::Transform& transform ) const
 	{
-		GetShapeValues( values, *this );
-		GetColourValues( values, *this );
+		return BatchShape( *this, batch, transform );
 	}
 
-	void Sprite::GetValues( std::vector< std::pair< std::string, std::string > >& values ) const
+	bool ConvexShape::Batch( Reflex::Core::RenderBatch& batch, const sf::Transform& transform ) const
 	{
-		TODO( "Serialise sprite texture somehow" );
-		if( !Reflex::IsDefault( getColor() ) )
-			values.emplace_back( "Colour", Reflex::ToString( getColor() ) );
+		return BatchShape( *this, batch, transform );
 	}
 
-	void Text::GetValues( std::vector< std::pair< std::string, std::string > >& values ) const
+	bool Sprite::Batch( Reflex::Core::RenderBatch& batch, const sf::Transform& transform ) const
 	{
-		GetColourValues( values, *this );
-		values.emplace_back( "String", getString() );
-		values.emplace_back( "Style", Reflex::ToString( getStyle() ) );
+		// sf::Sprite doesn't draw anything without a texture
+		if( !getTexture() )
+			return true;
+
+		const auto finalTransform = transform * getTransform();
+		const auto rect = getTextureRect();
+		const auto width = float( std::abs( rect.width ) );
+		const auto height = float( std::abs( rect.height ) );
+		const auto left = float( rect.left );
+		const auto top = float( rect.top );
+		const auto right = left + float( rect.width );
+		const auto bottom = top + float( rect.height );
+		const auto colour = getColor();
+
+		const sf::Vertex topLeft( finalTransform.transformPoint( 0.0f, 0.0f ), colour, sf::Vector2f( left, top ) );
+		const sf::Vertex bottomLeft( finalTransform.transformPoint( 0.0f, height ), colour, sf::Vector2f( left, bottom ) );
+		const sf::Vertex topRight( finalTransform.transformPoint( width, 0.0f ), colour, sf::Vector2f( right, top ) );
+		const sf::Vertex bottomRight( finalTransform.transformPoint( width, height ), colour, sf::Vector2f( right, bottom ) );
+
+		auto* vertices = batch.Allocate( getTexture(), 6 );
+		vertices[0] = topLeft;
+		vertices[1] = bottomLeft;
+		vertices[2] = topRight;
+		vertices[3] = topRight;
+		vertices[4] = bottomLeft;
+		vertices[5] = bottomRight;
+		return true;
 	}
 
 	void CircleShape::CreateRigidBody( const b2BodyType type )
@@ -12,10 +12,10 @@ namespace Reflex::Components
 		explicit CircleShape( const Reflex::Object& owner, const std::optional< sf::Color > colour = std::nullopt );
 
 		static std::string GetComponentName() { return "CircleShape"; }
-		bool SetValue( const std::string& variable, const std::string& value ) override;
-		void GetValues( std::vector< std::pair< std::string, std::string > >& values ) const override;
+		static Reflex::Core::FieldTable GetFields();
 		bool IsRenderComponent() const final { return true; }
 		void Render( sf::RenderTarget& target, sf::RenderStates states ) const final { target.draw( *this, states ); }
+		bool Batch( Reflex::Core::RenderBatch& batch, const sf::Transform& transform ) const final;
 
 		void CreateRigidBody( const b2BodyType type = b2BodyType::b2_staticBody );
 	};
@@ -27,10 +27,10 @@ namespace Reflex::Components
 		explicit RectangleShape( const Reflex::Object& owner, const std::optional< sf::Color > colour = std::nullopt );
 
 		static std::string GetComponentName() { return "RectangleShape"; }
-		bool SetValue( const std::string& variable, const std::string& value ) override;
-		void GetValues( std::vector< std::pair< std::string, std::string > >& values ) const override;
+		static Reflex::Core::FieldTable GetFields();
 		bool IsRenderComponent() const final { return true; }
 		void Render( sf::RenderTarget& target, sf::RenderStates states ) const final { target.draw( *this, states ); }
+		bool Batch( Reflex::Core::RenderBatch& batch, const sf::Transform& transform ) const final;
 
 		void CreateRigidBody( const b2BodyType type = b2BodyType::b2_staticBody );
 	};
@@ -43,12 +43,15 @@ namespace Reflex::Components
 		explicit ConvexShape( const Reflex::Object& owner, const std::optional< sf::Color > colour = std::nullopt );
 
 		static std::string GetComponentName() { return "ConvexShape"; }
-		bool SetValue( const std::string& variable, const std::string& value ) override;
-		void GetValues( std::vector< std::pair< std::string, std::string > >& values ) const override;
+		static Reflex::Core::FieldTable GetFields();
 		bool IsRenderComponent() const final { return true; }
 		void Render( sf::RenderTarget& target, sf::RenderStates states ) const final { target.draw( *this, states ); }
+		bool Batch( Reflex::Core::RenderBatch& batch, const sf::Transform& transform ) const final;
 
 		void CreateRigidBody( const b2BodyType type = b2BodyType::b2_staticBody );
+
+		std::vector< sf::Vector2f > GetPoints() const;
+		void SetPoints( const std::vector< sf::Vector2f >& points );
 	};
 
 	class Sprite : public Component< Sprite >, public sf::Sprite
@@ -59,10 +62,10 @@ namespace Reflex::Components
 		explicit Sprite( const Reflex::Object& owner, const std::optional< sf::Color > colour = std::nullopt );
 
 		static std::string GetComponentName() { return "Sprite"; }
-		bool SetValue( const std::string& variable, const std::string& value ) override;
-		void GetValues( std::vector< std::pair< std::string, std::string > >& values ) const override;
+		static Reflex::Core::FieldTable GetFields();
 		bool IsRenderComponent() const final { return true; }
 		void Render( sf::RenderTarget& target, sf::RenderStates states ) const final { target.draw( *this, states ); }
+		bool Batch( Reflex::Core::RenderBatch& batch, const sf::Transform& transform ) const final;
 	};
 
 	class Text : public Component< Text >, public sf::Text
@@ -72,28 +75,8 @@ namespace Reflex::Components
 		explicit Text( const Reflex::Object& owner, const std::optional< sf::Color > colour = std::nullopt );
 
 		static std::string GetComponentName() { return "Text"; }
-		bool SetValue( const std::string& variable, const std::string& value ) override;
-		void GetValues( std::vector< std::pair< std::string, std::string > >& values ) const override;
+		static Reflex::Core::FieldTable GetFields();
 		bool IsRenderComponent() const final { return true; }
 		void Render( sf::RenderTarget& target, sf::RenderStates states ) const final { target.draw( *this, states ); }
 	};
-
-	template< typename V >
-	void GetColourValues( std::vector< std::pair< std::string, std::string > >& values, const V& shape )
-	{
-		if( !Reflex::IsDefault( shape.getFillColor() ) )
-			values.emplace_back( "FillColour", Reflex::ToString( shape.getFillColor() ) );
-		if( !Reflex::IsDefault( shape.getOutlineColor() ) )
-			values.emplace_back( "OutlineColour", Reflex::ToString( shape.getOutlineColor() ) );
-	}
-
-	template< typename V >
-	void GetShapeValues( std::vector< std::pair< std::string, std::string > >& values, const V& shape )
-	{
-		values.emplace_back( "PointCount", Reflex::ToString( shape.getPointCount() ) );
-		values.emplace_back( "Points", "" );
-		for( size_t i = 0; i < shape.getPointCount(); ++i )
-			values.back().second += ( i > 0 ? ", " : "" ) + Reflex::ToString( shape.getPoint( i ) );
-	}
-
 }
\ No newline at end of file
@@ -8,68 +8,41 @@ namespace Reflex::Core
 {
 	SceneNode::SceneNode( const Reflex::Object& owner )
 		: m_owningObject( owner )
-		, m_parent()
-		, m_children()
 	{
-
+		GetHierarchy().Add( owner );
 	}
 
 	SceneNode::SceneNode( const SceneNode& other )
-		: m_owningObject( other.m_owningObject )
-		, m_parent( other.m_parent )
-		, m_children( other.m_children )
+		: sf::Transformable( other )
+		, m_owningObject( other.m_owningObject )
 	{
 
 	}
 
-	SceneNode::~SceneNode()
-	{
-		if( m_parent )
-			m_parent.GetTransform()->DetachChild( GetObject() );
-	}
-
 	void SceneNode::AttachChild( const Reflex::Object& child )
 	{
 		auto transform = child.GetTransform();
 
-		if( transform->m_parent )
-			transform->m_parent.GetTransform()->DetachChild( child );
-
-		transform->m_parent = GetObject();
+		GetHierarchy().Attach( child, GetObject() );
 		transform->IncrementZOrder();
 		transform->SetLayer( GetObject().GetTransform()->GetLayer() + 1 );
-		m_children.push_back( child );
 	}
 
 	Reflex::Object SceneNode::DetachChild( const Reflex::Object& node )
 	{
-		// Find and detach the node'
-		for( unsigned i = 0U; i < m_children.size(); ++i )
+		if( GetHierarchy().GetParent( node ) != GetObject() )
 		{
-			if( node == m_children[i] )
-			{
-				if( m_children[i] )
-					if( const auto transform = m_children[i].GetTransform() )
-						transform->m_parent = Reflex::Object();
-
-				m_children.erase( m_children.begin() + i );
-				return node;
-			}
+			LOG_CRIT( "Node not found" );
+			return Reflex::Object();
 		}
 
-		LOG_CRIT( "Node not found" );
-		return Reflex::Object();
+		GetHierarchy().Detach( node );
+		return node;
 	}
 
 	sf::Transform SceneNode::GetWorldTransform() const
 	{
-		TODO( "Cache the world transform" );
-		sf::Transform worldTransform;
-
-		for( auto node = GetObject(); node.IsValid(); node = node.GetTransform()->m_parent )
-			worldTransform = node.GetTransform()->getTransform() * worldTransform;
-
-		return worldTransform;
+		return GetHierarchy().GetWorldTransform( m_owningObject );
 	}
 
 	sf::Vector2f SceneNode::GetWorldPosition() const
@@ -79,43 +52,109 @@ namespace Reflex::Core
 
 	sf::Vector2f SceneNode::GetWorldTranslation() const
 	{
-		sf::Vector2f worldTranslation;
+		return GetHierarchy().GetWorldTranslation( m_owningObject );
+	}
 
-		for( auto node = GetObject(); node.IsValid(); node = node.GetTransform()->m_parent )
-		{
-			worldTranslation.x += node.GetTransform()->getPosition().x;
-			worldTranslation.y += node.GetTransform()->getPosition().y;
-		}
+	float SceneNode::GetWorldRotation() const
+	{
+		return GetHierarchy().GetWorldRotation( m_owningObject );
+	}
 
-		return worldTranslation;
+	sf::Vector2f SceneNode::GetWorldScale() const
+	{
+		return GetHierarchy().GetWorldScale( m_owningObject );
 	}
 
-	float SceneNode::GetWorldRotation() const
+	void SceneNode::setPosition( float x, float y )
 	{
-		float worldRotation = 0.0f;
+		sf::Transformable::setPosition( x, y );
+		OnLocalTransformChanged();
+	}
 
-		for( auto node = GetObject(); node.IsValid(); node = node.GetTransform()->m_parent )
-			worldRotation += node.GetTransform()->getRotation();
+	void SceneNode::setPosition( const sf::Vector2f& position )
+	{
+		sf::Transformable::setPosition( position );
+		OnLocalTransformChanged();
+	}
 
-		return worldRotation;
+	void SceneNode::setRotation( float angle )
+	{
+		sf::Transformable::setRotation( angle );
+		OnLocalTransformChanged();
 	}
 
-	sf::Vector2f SceneNode::GetWorldScale() const
+	void SceneNode::setScale( float factorX, float factorY )
 	{
-		sf::Vector2f worldScale( 1.0f, 1.0f );
+		sf::Transformable::setScale( factorX, factorY );
+		OnLocalTransformChanged();
+	}
 
-		for( auto node = GetObject(); node.IsValid(); node = node.GetTransform()->m_parent )
-		{
-			worldScale.x *= node.GetTransform()->getScale().x;
-			worldScale.y *= node.GetTransform()->getScale().y;
-		}
+	void SceneNode::setScale( const sf::Vector2f& factors )
+	{
+		sf::Transformable::setScale( factors );
+		OnLocalTransformChanged();
+	}
 
-		return worldScale;
+	void SceneNode::setOrigin( float x, float y )
+	{
+		sf::Transformable::setOrigin( x, y );
+		OnLocalTransformChanged();
+	}
+
+	void SceneNode::setOrigin( const sf::Vector2f& origin )
+	{
+		sf::Transformable::setOrigin( origin );
+		OnLocalTransformChanged();
+	}
+
+	void SceneNode::move( float offsetX, float offsetY )
+	{
+		sf::Transformable::move( offsetX, offsetY );
+		OnLocalTransformChanged();
+	}
+
+	void SceneNode::move( const sf::Vector2f& offset )
+	{
+		sf::Transformable::move( offset );
+		OnLocalTransformChanged();
+	}
+
+	void SceneNode::rotate( float angle )
+	{
+		sf::Transformable::rotate( angle );
+		OnLocalTransformChanged();
+	}
+
+	void SceneNode::scale( float factorX, float factorY )
+	{
+		sf::Transformable::scale( factorX, factorY );
+		OnLocalTransformChanged();
+	}
+
+	void SceneNode::scale( const sf::Vector2f& factor )
+	{
+		sf::Transformable::scale( factor );
+		OnLocalTransformChanged();
+	}
+
+	void SceneNode::RemoveFromHierarchy()
+	{
+		GetHierarchy().Remove( m_owningObject );
+	}
+
+	void SceneNode::OnLocalTransformChanged()
+	{
+		GetHierarchy().SetLocal( m_owningObject, *this );
+	}
+
+	TransformHierarchy& SceneNode::GetHierarchy() const
+	{
+		return m_owningObject.GetWorld().GetTransformHierarchy();
 	}
 
 	unsigned SceneNode::GetChildrenCount() const
 	{
-		return ( unsigned )m_children.size();
+		return GetHierarchy().GetChildrenCount( m_owningObject );
 	}
 
 	Reflex::Object SceneNode::GetChild( const unsigned index ) const
@@ -126,12 +165,12 @@ namespace Reflex::Core
 			return Reflex::Object();
 		}
 
-		return m_children[index];
+		return GetHierarchy().GetChild( m_owningObject, index );
 	}
 
 	Reflex::Object SceneNode::GetParent() const
 	{
-		return m_parent;
+		return GetHierarchy().GetParent( m_owningObject );
 	}
 
 	Reflex::Object SceneNode::GetObject() const
@@ -2,15 +2,17 @@
 
 #include "Precompiled.h"
 #include "Object.h"
+#include "TransformHierarchy.h"
 
 namespace Reflex::Core
 {
+	// Parenting and world transforms are stored in the world's TransformHierarchy, world transforms are only recomputed when the node or one of its ancestors changes
+	// Changes go through the setters below (which hide the sf::Transformable ones) so the hierarchy's copy of the local transform stays in sync
 	class SceneNode : public sf::Transformable
 	{
 	public:
 		SceneNode( const Reflex::Object& owner );
 		SceneNode( const SceneNode& other );
-		~SceneNode();
 
 		void AttachChild( const Reflex::Object& child );
 		Reflex::Object DetachChild( const Reflex::Object& node );
@@ -22,10 +24,27 @@ namespace Reflex::Core
 		float GetWorldRotation() const;
 		sf::Vector2f GetWorldScale() const;
 
+		void setPosition( float x, float y );
+		void setPosition( const sf::Vector2f& position );
+		void setRotation( float angle );
+		void setScale( float factorX, float factorY );
+		void setScale( const sf::Vector2f& factors );
+		void setOrigin( float x, float y );
+		void setOrigin( const sf::Vector2f& origin );
+		void move( float offsetX, float offsetY );
+		void move( const sf::Vector2f& offset );
+		void rotate( float angle );
+		void scale( float factorX, float factorY );
+		void scale( const sf::Vector2f& factor );
+
 		template< typename Func >
-		void ForEachChild( Func function )
+		void ForEachChild( Func function ) const
 		{
-			std::for_each( m_children.begin(), m_children.end(), function );
+			GetHierarchy().ForEachChild( m_owningObject, [&]( const BaseObject& child )
+			{
+				const Reflex::Object object( child );
+				function( object );
+			} );
 		}
 
 		unsigned GetChildrenCount() const;
@@ -33,9 +52,14 @@ namespace Reflex::Core
 		Reflex::Object GetParent() const;
 		Reflex::Object GetObject() const;
 
+	protected:
+		// Removes this node from the hierarchy, its children become roots (called when the owning transform is destroyed)
+		void RemoveFromHierarchy();
+		void OnLocalTransformChanged();
+
+		TransformHierarchy& GetHierarchy() const;
+
 	protected:
 		Reflex::Object m_owningObject;
-		Reflex::Object m_parent;
-		std::vector< Reflex::Object > m_children;
 	};
 }
\ No newline at end of file
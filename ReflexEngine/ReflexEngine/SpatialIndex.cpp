@@ -0,0 +1,157 @@
+#include "Precompiled.h"
+#include "SpatialIndex.h"
+#include "Object.h"
+#include "TransformComponent.h"
+#include "JobSystem.h"
+
+namespace Reflex::Core
+{
+	void SpatialIndex::Reset()
+	{
+		for( const auto& moved : m_movedObjects )
+		{
+			const Object object( moved );
+			if( object.IsValid() && object.HasComponent< Reflex::Components::Transform >() )
+				object.GetTransform()->m_spatialIndexDirty = false;
+		}
+
+		m_movedObjects.clear();
+		Clear();
+	}
+
+	void SpatialIndex::Repopulate( World& world )
+	{
+		Reset();
+
+		// Objects whose transform doesn't use the index (eg. the scene root) are skipped
+		for( const auto object : world.GetObjects() )
+		{
+			const auto transform = object.GetTransform();
+			if( transform && transform->m_useTileMap )
+				Insert( object );
+		}
+	}
+
+	void SpatialIndex::Move( const Object& object )
+	{
+		assert( object );
+		auto transform = object.GetTransform();
+
+		if( m_deferMoves )
+		{
+			if( !transform->m_spatialIndexDirty )
+			{
+				transform->m_spatialIndexDirty = true;
+				m_movedObjects.push_back( object );
+			}
+			return;
+		}
+
+		const auto location = Locate( object );
+
+		if( location != transform->m_spatialIndexLocation )
+			Relocate( object, location );
+	}
+
+	void SpatialIndex::BeginDeferredMoves()
+	{
+		m_deferMoves = true;
+	}
+
+	void SpatialIndex::EndDeferredMoves( JobSystem& jobSystem )
+	{
+		m_deferMoves = false;
+
+		if( m_movedObjects.empty() )
+			return;
+
+		// Working out the new locations only reads transforms, so it is split across the job system
+		m_pendingMoves.resize( m_movedObjects.size() );
+
+		jobSystem.ParallelFor( m_movedObjects.size(), 256, [&]( const std::size_t begin, const std::size_t end )
+		{
+			for( auto i = begin; i < end; ++i )
+			{
+				const Object object( m_movedObjects[i] );
+				auto& move = m_pendingMoves[i];
+
+				// Objects can be destroyed (or lose their transform) after being moved
+				move.valid = object.IsValid() && object.HasComponent< Reflex::Components::Transform >();
+				if( move.valid )
+					move.location = Locate( object );
+			}
+		} );
+
+		for( std::size_t i = 0; i < m_movedObjects.size(); ++i )
+		{
+			const auto& move = m_pendingMoves[i];
+			if( !move.valid )
+				continue;
+
+			const Object object( m_movedObjects[i] );
+			auto transform = object.GetTransform();
+
+			if( !transform->m_spatialIndexDirty )
+				continue;
+
+			transform->m_spatialIndexDirty = false;
+
+			if( move.location != transform->m_spatialIndexLocation )
+				Relocate( object, move.location );
+		}
+
+		m_movedObjects.clear();
+	}
+
+	void SpatialIndex::GetNearby( const Object& object, const float distance, std::vector< Object >& out ) const
+	{
+		ForEachInRange( object, distance, [&out]( const Object& obj )
+		{
+			out.push_back( obj );
+		} );
+	}
+
+	void SpatialIndex::GetNearby( const sf::Vector2f& position, const float distance, std::vector< Object >& out ) const
+	{
+		ForEachInRange( position, distance, [&out]( const Object& obj )
+		{
+			out.push_back( obj );
+		} );
+	}
+
+	void SpatialIndex::GetNearby( const sf::FloatRect& boundary, std::vector< Object >& out ) const
+	{
+		ForEachInBounds( boundary, [&out]( const Object& obj )
+		{
+			out.push_back( obj );
+		} );
+	}
+
+	SpatialIndexLocation& SpatialIndex::GetLocation( const Object& object )
+	{
+		return object.GetTransform()->m_spatialIndexLocation;
+	}
+
+	sf::FloatRect SpatialIndex::GetObjectBounds( const Object& object )
+	{
+		const auto transform = object.GetTransform();
+		const auto bounds = transform->GetGlobalBounds();
+
+		if( bounds.width <= 0.0f && bounds.height <= 0.0f )
+			return sf::FloatRect( transform->GetWorldPosition(), sf::Vector2f() );
+
+		if( bounds.rotation == 0.0f )
+			return bounds;
+
+		// A rect rotated about its centre always fits in a square the size of its diagonal
+		const auto centre = sf::Vector2f( bounds.left + bounds.width / 2.0f, bounds.top + bounds.height / 2.0f );
+		const auto halfDiagonal = Reflex::GetMagnitude( sf::Vector2f( bounds.width, bounds.height ) ) / 2.0f;
+		return sf::FloatRect( centre - sf::Vector2f( halfDiagonal, halfDiagonal ), sf::Vector2f( halfDiagonal, halfDiagonal ) * 2.0f );
+	}
+
+	sf::Vector2f SpatialIndex::GetObjectPosition( const BaseObject& object )
+	{
+		assert( Object( object ).IsValid() );
+		return Object( object ).GetTransform()->getPosition();
+	}
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "BaseObject.h"
+
+namespace Reflex { class Object; }
+
+namespace Reflex::Core
+{
+	class World;
+	class JobSystem;
+
+	// Where an object is stored in a spatial index, kept on its Transform so the index can find it again without searching
+	struct SpatialIndexLocation
+	{
+		sf::Vector2i cell;			// TileMap: chunk index, LooseQuadTree: node coordinates within its level
+		std::uint32_t id = 0U;		// TileMap: cell id within the chunk, LooseQuadTree: level
+
+		bool operator==( const SpatialIndexLocation& other ) const { return cell == other.cell && id == other.id; }
+		bool operator!=( const SpatialIndexLocation& other ) const { return !( *this == other ); }
+	};
+
+	// Common interface for the world's spatial index (see TileMap and LooseQuadTree), selected per world with World::SetSpatialIndex
+	// Objects are indexed through their Transform (only transforms created with useTileMap)
+	class SpatialIndex : sf::NonCopyable
+	{
+	public:
+		virtual ~SpatialIndex() { }
+
+		// Removes every object from the index
+		void Reset();
+
+		// Clears the index and re-inserts every object in the world that uses it
+		void Repopulate( World& world );
+
+		virtual void Insert( const Object& object ) = 0;
+		virtual void Remove( const Object& object ) = 0;
+
+		// Moves an object to the location matching its transform (called by Transform::setPosition)
+		// While moves are deferred this only marks the object, the index is updated once per object when the deferral ends
+		void Move( const Object& object );
+
+		// Whether an object's stored location no longer matches its transform, lets batched position writes (eg. the physics sync) skip Move for objects that stayed in the same cell
+		bool IsRelocated( const Object& object ) const { return Locate( object ) != GetLocation( object ); }
+
+		// Between Begin / EndDeferredMoves queries see moved objects where they were when the deferral began, so results are
+		// consistent for the whole of a pipeline stage. New locations are calculated across the job system and applied once per object
+		void BeginDeferredMoves();
+		void EndDeferredMoves( JobSystem& jobSystem );
+		bool IsDeferringMoves() const { return m_deferMoves; }
+
+		void GetNearby( const Object& object, const float distance, std::vector< Object >& out ) const;
+		void GetNearby( const sf::Vector2f& position, const float distance, std::vector< Object >& out ) const;
+		void GetNearby( const sf::FloatRect& boundary, std::vector< Object >& out ) const;
+
+		template< typename Func >
+		void ForEachInRange( const BaseObject& object, const float distance, Func f ) const;
+
+		template< typename Func >
+		void ForEachInRange( const sf::Vector2f& position, const float distance, Func f ) const;
+
+		template< typename Func >
+		void ForEachInBounds( const sf::FloatRect& boundary, Func f ) const;
+
+		// Frustum query, calls f for every object whose bounds overlap the area visible through the view (eg. a Camera component)
+		template< typename Func >
+		void ForEachInView( const sf::View& view, Func f ) const;
+
+	protected:
+		// Non-owning reference to a query callback, so queries don't allocate (the callable must outlive the call)
+		class CandidateCallback
+		{
+		public:
+			template< typename Func >
+			CandidateCallback( Func& function )
+				: m_function( &function )
+				, m_call( []( void* function, const Object& object ) { ( *static_cast< Func* >( function ) )( object ); } )
+			{
+			}
+
+			void operator()( const Object& object ) const { m_call( m_function, object ); }
+
+		private:
+			void* m_function = nullptr;
+			void( *m_call )( void*, const Object& ) = nullptr;
+		};
+
+		// Calls callback for objects stored near boundary, this may include objects outside of it but never the same object twice
+		virtual void ForEachCandidate( const sf::FloatRect& boundary, const CandidateCallback& callback ) const = 0;
+
+		// Location an object should be stored at based on its transform (must be safe to call from multiple threads)
+		virtual SpatialIndexLocation Locate( const Object& object ) const = 0;
+
+		// Moves an object from its stored location to newLocation
+		virtual void Relocate( const Object& object, const SpatialIndexLocation& newLocation ) = 0;
+
+		virtual void Clear() = 0;
+
+		static SpatialIndexLocation& GetLocation( const Object& object );
+
+		// World space AABB of an object's transform bounds (rotated bounds are expanded to contain any rotation), or a point at its position if it has no bounds
+		static sf::FloatRect GetObjectBounds( const Object& object );
+		static sf::Vector2f GetObjectPosition( const BaseObject& object );
+
+	private:
+		struct PendingMove
+		{
+			bool valid = false;
+			SpatialIndexLocation location;
+		};
+
+		bool m_deferMoves = false;
+		std::vector< BaseObject > m_movedObjects;
+		std::vector< PendingMove > m_pendingMoves;
+	};
+
+	// Template function definitions
+	template< typename Func >
+	void SpatialIndex::ForEachInRange( const BaseObject& object, const float distance, Func f ) const
+	{
+		ForEachInRange( GetObjectPosition( object ), distance, f );
+	}
+
+	template< typename Func >
+	void SpatialIndex::ForEachInRange( const sf::Vector2f& position, const float distance, Func f ) const
+	{
+		const sf::FloatRect bounds( position - sf::Vector2f( distance, distance ), sf::Vector2f( distance, distance ) * 2.0f );
+		auto filter = [&]( const Reflex::Object& object )
+		{
+			if( Reflex::GetDistanceSq( position, object.GetTransform()->getPosition() ) <= distance * distance )
+				f( object );
+		};
+
+		ForEachCandidate( bounds, CandidateCallback( filter ) );
+	}
+
+	template< typename Func >
+	void SpatialIndex::ForEachInBounds( const sf::FloatRect& boundary, Func f ) const
+	{
+		// Inclusive overlap test so objects without bounds (a point at their position) are still found
+		auto filter = [&]( const Reflex::Object& object )
+		{
+			const auto bounds = GetObjectBounds( object );
+			if( bounds.left <= boundary.left + boundary.width && bounds.left + bounds.width >= boundary.left &&
+				bounds.top <= boundary.top + boundary.height && bounds.top + bounds.height >= boundary.top )
+				f( object );
+		};
+
+		ForEachCandidate( boundary, CandidateCallback( filter ) );
+	}
+
+	template< typename Func >
+	void SpatialIndex::ForEachInView( const sf::View& view, Func f ) const
+	{
+		// The inverse view transform maps normalised device coordinates back to the world, transformRect gives the AABB (including view rotation)
+		ForEachInBounds( view.getInverseTransform().transformRect( sf::FloatRect( -1.0f, -1.0f, 2.0f, 2.0f ) ), f );
+	}
+}
@@ -19,59 +19,40 @@ namespace Reflex::Components
 		"Obstacle Avoidance",
 	};
 
-	bool Steering::SetValue( const std::string& variable, const std::string& value )
-	{
-		TrySetValue( "MaxForce", m_maxForce );
-		TrySetValue( "Mass", m_mass );
-		TrySetValue( "SlowingRadius", m_slowingRadius );
-		TrySetValue( "WanderCircleRadius", m_wanderCircleRadius );
-		TrySetValue( "WanderJitter", m_wanderJitter );
-		TrySetValue( "WanderCircleDistance", m_wanderCircleDistance );
-		TrySetValue( "NeighbourRange", m_neighbourRange );
-		TrySetValue( "AlignmentForce", m_alignmentForce );
-		TrySetValue( "CohesionForce", m_cohesionForce );
-		TrySetValue( "SeparationForce", m_separationForce );
-
-		for( unsigned i = 0; i < std::size( steeringBehaviourNames ); ++i )
-		{
-			if( variable == steeringBehaviourNames[i] )
-			{
-				m_behaviours.set( i, Reflex::FromString< bool >( value ) );
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	void Steering::GetValues( std::vector< std::pair< std::string, std::string > >& values ) const
+	Reflex::Core::FieldTable Steering::GetFields()
 	{
-		for( unsigned i = 0; i < std::size( steeringBehaviourNames ); ++i )
-			if( m_behaviours.test( i ) )
-				values.emplace_back( steeringBehaviourNames[i], "true" );
-
-		GetValue( "MaxForce", m_maxForce );
-		GetValue( "Mass", m_maxForce );
-		TryGetValue( "SlowingRadius", m_slowingRadius, IsBehaviourSet( SteeringBehaviours::Arrival ) );
-
-		// Wander
-		if( IsBehaviourSet( SteeringBehaviours::Wander ) )
+		static constexpr Reflex::Core::Field fields[] =
 		{
-			GetValue( "WanderCircleRadius", m_wanderCircleRadius );
-			GetValue( "WanderCircleDistance", m_wanderCircleDistance );
-			GetValue( "WanderJitter", m_wanderJitter );
-		}
-
-		// Flocking
-		if( IsBehaviourSet( SteeringBehaviours::Alignment ) ||
-			IsBehaviourSet( SteeringBehaviours::Cohesion ) ||
-			IsBehaviourSet( SteeringBehaviours::Separation ) )
-		{
-			GetValue( "NeighbourRange", m_neighbourRange );
-			TryGetValue( "AlignmentForce", m_alignmentForce, IsBehaviourSet( SteeringBehaviours::Alignment ) );
-			TryGetValue( "CohesionForce", m_cohesionForce, IsBehaviourSet( SteeringBehaviours::Cohesion ) );
-			TryGetValue( "SeparationForce", m_separationForce, IsBehaviourSet( SteeringBehaviours::Separation ) );
-		}
+			ReflectFlag( Steering, "Seek", m_behaviours, ( size_t )SteeringBehaviours::Seek ),
+			ReflectFlag( Steering, "Flee", m_behaviours, ( size_t )SteeringBehaviours::Flee ),
+			ReflectFlag( Steering, "Arrival", m_behaviours, ( size_t )SteeringBehaviours::Arrival ),
+			ReflectFlag( Steering, "Wander", m_behaviours, ( size_t )SteeringBehaviours::Wander ),
+			ReflectFlag( Steering, "Pursue", m_behaviours, ( size_t )SteeringBehaviours::Pursue ),
+			ReflectFlag( Steering, "Evade", m_behaviours, ( size_t )SteeringBehaviours::Evade ),
+			ReflectFlag( Steering, "Alignment", m_behaviours, ( size_t )SteeringBehaviours::Alignment ),
+			ReflectFlag( Steering, "Cohesion", m_behaviours, ( size_t )SteeringBehaviours::Cohesion ),
+			ReflectFlag( Steering, "Separation", m_behaviours, ( size_t )SteeringBehaviours::Separation ),
+			ReflectFlag( Steering, "Obstacle Avoidance", m_behaviours, ( size_t )SteeringBehaviours::ObstacleAvoidance ),
+			ReflectMember( Steering, "MaxForce", m_maxForce ),
+			ReflectMember( Steering, "Mass", m_mass ),
+			ReflectMemberIf( Steering, "SlowingRadius", m_slowingRadius, component.IsBehaviourSet( SteeringBehaviours::Arrival ) ),
+
+			// Wander
+			ReflectMemberIf( Steering, "WanderCircleRadius", m_wanderCircleRadius, component.IsBehaviourSet( SteeringBehaviours::Wander ) ),
+			ReflectMemberIf( Steering, "WanderCircleDistance", m_wanderCircleDistance, component.IsBehaviourSet( SteeringBehaviours::Wander ) ),
+			ReflectMemberIf( Steering, "WanderJitter", m_wanderJitter, component.IsBehaviourSet( SteeringBehaviours::Wander ) ),
+
+			// Flocking
+			ReflectMemberIf( Steering, "NeighbourRange", m_neighbourRange, component.IsBehaviourSet( SteeringBehaviours::Alignment ) ||
+				component.IsBehaviourSet( SteeringBehaviours::Cohesion ) || component.IsBehaviourSet( SteeringBehaviours::Separation ) ),
+			ReflectMemberIf( Steering, "AlignmentForce", m_alignmentForce, component.IsBehaviourSet( SteeringBehaviours::Alignment ) ),
+			ReflectMemberIf( Steering, "CohesionForce", m_cohesionForce, component.IsBehaviourSet( SteeringBehaviours::Cohesion ) ),
+			ReflectMemberIf( Steering, "SeparationForce", m_separationForce, component.IsBehaviourSet( SteeringBehaviours::Separation ) ),
+			ReflectMemberIf( Steering, "NeighbourSkin", m_neighbourSkin, component.m_neighbourSkin > 0.0f ),
+			ReflectMemberIf( Steering, "MaxNeighbours", m_maxNeighbours, component.m_maxNeighbours > 0U ),
+		};
+
+		return fields;
 	}
 
 	void Steering::Seek( const sf::Vector2f& target, const float maxVelocity )
@@ -152,6 +133,14 @@ namespace Reflex::Components
 		Separation( neighbourRange, separationForce, maxVelocity );
 	}
 
+	void Steering::CacheNeighbours( const float skin, const unsigned maxNeighbours )
+	{
+		m_neighbourSkin = skin;
+		m_maxNeighbours = maxNeighbours;
+		m_neighboursValid = false;
+		m_neighbours.clear();
+	}
+
 	void Steering::ObstacleAvoidance( const float avoidanceForce, const float maxVelocity )
 	{
 		SetBehaviourInternal( SteeringBehaviours::ObstacleAvoidance );
@@ -217,6 +206,8 @@ namespace Reflex::Components
 		m_alignmentForce = other->m_alignmentForce;
 		m_cohesionForce = other->m_cohesionForce;
 		m_separationForce = other->m_separationForce;
+		m_neighbourSkin = other->m_neighbourSkin;
+		m_maxNeighbours = other->m_maxNeighbours;
 		m_avoidanceForce = other->m_avoidanceForce;
 		m_forceMultiplier = other->m_forceMultiplier;
 		m_targetObject = other->m_targetObject;
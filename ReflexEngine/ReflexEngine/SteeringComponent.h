@@ -3,6 +3,7 @@
 #include "Component.h"
 #include "Utility.h"
 #include "Object.h"
+#include <random>
 
 namespace Reflex::Systems { class SteeringSystem; }
 
@@ -33,9 +34,8 @@ namespace Reflex::Components
 		typedef std::bitset< ( size_t )SteeringBehaviours::NumBehaviours > BehaviourFlags;
 
 		using Component< Steering >::Component;
-		bool SetValue( const std::string& variable, const std::string& value ) override;
-		void GetValues( std::vector< std::pair< std::string, std::string > >& values ) const override;
 		static std::string GetComponentName() { return "Steering"; }
+		static Reflex::Core::FieldTable GetFields();
 
 		void Seek( const sf::Vector2f& target, const float maxVelocity );
 		void Flee( const sf::Vector2f& target, const float maxVelocity );
@@ -51,6 +51,11 @@ namespace Reflex::Components
 		
 		void ObstacleAvoidance( const float avoidanceForce, const float maxVelocity );
 
+		// Caches the boid's neighbours (Verlet list) for the flocking behaviours, neighbours within range + skin are stored and the spatial index is
+		// only queried again once the boid has moved more than half the skin. maxNeighbours keeps only the nearest (0 keeps all), a skin of 0 disables it
+		void CacheNeighbours( const float skin, const unsigned maxNeighbours = 0U );
+		const std::vector< Reflex::Object >& GetCachedNeighbours() const { return m_neighbours; }
+
 		void EnableBehaviour( const SteeringBehaviours behaviour );
 		void DisableBehaviour( const SteeringBehaviours behaviour );
 		void ClearBehaviours();
@@ -89,6 +94,8 @@ namespace Reflex::Components
 		float m_alignmentForce = 1.0f;
 		float m_cohesionForce = 1.0f;
 		float m_separationForce = 1.0f;
+		float m_neighbourSkin = 0.0f;
+		unsigned m_maxNeighbours = 0U;
 
 		// Avoidance
 		float m_avoidanceForce = 1.0f;
@@ -103,5 +110,13 @@ namespace Reflex::Components
 		Reflex::Object m_targetObject;
 		sf::Vector2f m_targetPosition;
 		sf::Vector2f m_wanderDirection;
+		// Wander runs on the job system workers, so each boid draws from its own generator (seeded from rand() when the component is added)
+		std::minstd_rand m_random{ ( std::minstd_rand::result_type )rand() };
+
+		// Cached neighbours, with the position and range + skin they were gathered at
+		std::vector< Reflex::Object > m_neighbours;
+		sf::Vector2f m_neighboursPosition;
+		float m_neighboursRadius = 0.0f;
+		bool m_neighboursValid = false;
 	};
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "World.h"
 #include "Logging.h"
 #include "SFMLObjectComponent.h"
+#include "RigidBodyComponent.h"
 
 namespace Reflex::Systems
 {
@@ -12,28 +13,45 @@ namespace Reflex::Systems
 	void SteeringSystem::RegisterComponents()
 	{
 		RequiresComponent( Reflex::Components::Steering );
+		WritesComponent( Reflex::Components::Steering );
+		WritesComponent( Transform );
+		ReadsComponent( Reflex::Components::RigidBody );
 	}
 
 	void SteeringSystem::Update( const float deltaTime )
 	{
 		PROFILE;
-		ForEachObject< Reflex::Components::Steering >( [&]( const Reflex::Components::Steering::Handle& boid )
+		// Steering uses packed storage, so the view walks the live boids directly instead of the (sparse) object list
+		const auto view = GetWorld().GetView< Reflex::Components::Steering, Transform >();
+
+		// Calculating the forces only reads other boids, so it is split across the job system, velocities are then applied in a second pass
+		view.ParallelForEach( GetWorld().GetJobSystem(), [&]( Reflex::Components::Steering& boid, Transform& transform )
+		{
+			CalculateSteering( boid, transform );
+		} );
+
+		view.ForEach( [&]( Reflex::Components::Steering& boid, Transform& transform )
 		{
-			Integrate( boid, deltaTime );
+			Integrate( boid, transform, deltaTime );
 		} );
 	}
 
-	void SteeringSystem::Integrate( const Steering::Handle& boid, const float deltaTime ) const
+	void SteeringSystem::CalculateSteering( Reflex::Components::Steering& boid, const Transform& transform ) const
 	{
 		PROFILE;
-		auto transform = boid->GetObject().GetTransform();
+		if( boid.m_maxForce <= 0.0f || transform.GetMaxVelocity() <= 0.0f )
+			return;
+
+		boid.m_steering = Steering( boid.GetHandle() );
+	}
 
-		if( boid->m_maxForce <= 0.0f || transform->GetMaxVelocity() <= 0.0f )
+	void SteeringSystem::Integrate( Reflex::Components::Steering& boid, Transform& transform, const float deltaTime ) const
+	{
+		if( boid.m_maxForce <= 0.0f || transform.GetMaxVelocity() <= 0.0f )
 			return;
 
-		boid->m_steering = Steering( boid );
-		const auto acceleration = boid->m_steering / boid->m_mass;
-		transform->SetVelocity( transform->GetVelocity() + acceleration * deltaTime );
+		const auto acceleration = boid.m_steering / boid.m_mass;
+		transform.SetVelocity( transform.GetVelocity() + acceleration * deltaTime );
 	}
 
 	sf::Vector2f SteeringSystem::Steering( const Steering::Handle& boid ) const
@@ -96,16 +114,20 @@ namespace Reflex::Systems
 		if( boid->m_wanderCircleRadius <= 0.0f )
 			return {};
 
-		auto transform = boid->GetObject().GetTransform();
+		const auto transform = boid->GetObject().GetTransform();
 
-		if( transform->GetVelocity().x == 0.0f && transform->GetVelocity().y == 0.0f )
-			transform->SetVelocity( Reflex::RandomUnitVector() );
+		// Reflex::Random* wrap rand(), which isn't safe to call from the workers, so the boid's own generator is used instead
+		// Pick a random heading when stationary (the velocity isn't written here as other boids may be reading it)
+		auto velocity = transform->GetVelocity();
+		if( velocity.x == 0.0f && velocity.y == 0.0f )
+			velocity = Reflex::RotateVector( sf::Vector2f( 1.0f, 0.0f ), std::uniform_real_distribution< float >( 0.0f, PI2 )( boid->m_random ) );
 
-		boid->m_wanderDirection.x += Reflex::RandomFloat( -boid->m_wanderJitter / 2.0f, boid->m_wanderJitter / 2.0f ) * GetWorld().GetDeltaTime();
-		boid->m_wanderDirection.y += Reflex::RandomFloat( -boid->m_wanderJitter / 2.0f, boid->m_wanderJitter / 2.0f ) * GetWorld().GetDeltaTime();
+		std::uniform_real_distribution< float > jitter( -boid->m_wanderJitter / 2.0f, boid->m_wanderJitter / 2.0f );
+		boid->m_wanderDirection.x += jitter( boid->m_random ) * GetWorld().GetDeltaTime();
+		boid->m_wanderDirection.y += jitter( boid->m_random ) * GetWorld().GetDeltaTime();
 		Reflex::ScaleTo( boid->m_wanderDirection, boid->m_wanderCircleRadius );
-		const auto targetForce = Reflex::ScaleTo( Reflex::ScaleTo( transform->GetVelocity(), boid->m_wanderCircleDistance ) + boid->m_wanderDirection, transform->GetMaxVelocity() );
-		return ( targetForce - transform->GetVelocity() ) * boid->m_wanderForce * boid->m_forceMultiplier;
+		const auto targetForce = Reflex::ScaleTo( Reflex::ScaleTo( velocity, boid->m_wanderCircleDistance ) + boid->m_wanderDirection, transform->GetMaxVelocity() );
+		return ( targetForce - velocity ) * boid->m_wanderForce * boid->m_forceMultiplier;
 	}
 
 	sf::Vector2f SteeringSystem::Pursue( const Steering::Handle& boid, const Object& target, const bool useArrival ) const
@@ -127,35 +149,37 @@ namespace Reflex::Systems
 
 	sf::Vector2f SteeringSystem::Flocking( const Steering::Handle& boid ) const
 	{
-		sf::Vector2f alignment, cohesion, separation;
 		const auto pos = boid->GetTransform()->getPosition();
-		unsigned counter = 0;
 
-#ifndef DISABLE_TILEMAP
-		GetWorld().GetTileMap().ForEachInRange( pos, boid->m_neighbourRange, [&]( const Reflex::Object& nearby )
-		{
-			if( boid == nearby || !nearby.HasComponent< Reflex::Components::Steering >() )
-				return;
-#else
-		ForEachObject< Reflex::Components::Steering >( [&]( const Reflex::Components::Steering::Handle& steering )
-		{
-			const auto nearby = steering->GetObject();
+		// Neighbours are gathered first and the forces summed by the flocking kernel, boids are calculated in parallel so each thread has its own buffers
+		static thread_local FlockingNeighbours neighbours;
+		neighbours.Clear();
 
-			if( boid == nearby )
-				return;
-#endif
+		const auto addNeighbour = [&]( const Reflex::Object& nearby )
+		{
 			const auto nearbyTransform = nearby.GetTransform();
 			const auto nearbyPos = nearbyTransform->getPosition();
-			const auto direction = pos - nearbyPos;
 
-			if( Reflex::GetMagnitudeSq( direction ) > boid->m_neighbourRange * boid->m_neighbourRange )
-				return;
+			if( Reflex::GetDistanceSq( pos, nearbyPos ) <= boid->m_neighbourRange * boid->m_neighbourRange )
+				neighbours.Add( nearbyPos, nearbyTransform->GetVelocity() );
+		};
 
-			counter++;
-			alignment += Reflex::Normalise( nearbyTransform->GetVelocity() );
-			cohesion += nearbyPos;
-			separation += direction / -Reflex::GetMagnitudeSq( direction );
-		} );
+		if( boid->m_neighbourSkin > 0.0f )
+		{
+			UpdateNeighbourList( boid );
+
+			// Cached neighbours can have been destroyed (or lost their steering) since the list was built
+			for( const auto& nearby : boid->m_neighbours )
+				if( nearby.IsValid() && nearby.HasComponent< Reflex::Components::Steering >() )
+					addNeighbour( nearby );
+		}
+		else
+		{
+			ForEachNearbyBoid( boid, boid->m_neighbourRange, addNeighbour );
+		}
+
+		const auto counter = neighbours.Size();
+		auto [alignment, cohesion, separation] = SumFlockingForces( neighbours, pos );
 
 		if( counter )
 		{
@@ -178,6 +202,61 @@ namespace Reflex::Systems
 		return alignment * alignmentForce + cohesion * cohesionForce + separation * separationForce;
 	}
 
+	void SteeringSystem::UpdateNeighbourList( const Steering::Handle& boid ) const
+	{
+		PROFILE;
+		const auto pos = boid->GetTransform()->getPosition();
+		const auto radius = boid->m_neighbourRange + boid->m_neighbourSkin;
+		const auto halfSkin = boid->m_neighbourSkin / 2.0f;
+
+		// Nothing that was outside range + skin can have come within range until the boid has moved half the skin (assuming neighbours move at similar speeds)
+		if( boid->m_neighboursValid && boid->m_neighboursRadius == radius && Reflex::GetDistanceSq( pos, boid->m_neighboursPosition ) <= halfSkin * halfSkin )
+			return;
+
+		auto& neighbours = boid->m_neighbours;
+		neighbours.clear();
+
+		ForEachNearbyBoid( boid, radius, [&]( const Reflex::Object& nearby )
+		{
+			neighbours.push_back( nearby );
+		} );
+
+		if( boid->m_maxNeighbours > 0U && neighbours.size() > boid->m_maxNeighbours )
+		{
+			const auto last = neighbours.begin() + boid->m_maxNeighbours;
+			std::nth_element( neighbours.begin(), last, neighbours.end(), [&pos]( const Reflex::Object& a, const Reflex::Object& b )
+			{
+				return Reflex::GetDistanceSq( pos, a.GetTransform()->getPosition() ) < Reflex::GetDistanceSq( pos, b.GetTransform()->getPosition() );
+			} );
+			neighbours.erase( last, neighbours.end() );
+		}
+
+		boid->m_neighboursPosition = pos;
+		boid->m_neighboursRadius = radius;
+		boid->m_neighboursValid = true;
+	}
+
+	template< typename Func >
+	void SteeringSystem::ForEachNearbyBoid( const Steering::Handle& boid, const float range, Func f ) const
+	{
+#ifndef DISABLE_TILEMAP
+		GetWorld().GetSpatialIndex().ForEachInRange( boid->GetTransform()->getPosition(), range, [&]( const Reflex::Object& nearby )
+		{
+			if( boid != nearby && nearby.HasComponent< Reflex::Components::Steering >() )
+				f( nearby );
+		} );
+#else
+		// Without a spatial index every boid is a candidate, callers still check the range
+		ForEachObject< Reflex::Components::Steering >( [&]( const Reflex::Components::Steering::Handle& steering )
+		{
+			const auto nearby = steering->GetObject();
+
+			if( boid != nearby )
+				f( nearby );
+		} );
+#endif
+	}
+
 	sf::Vector2f SteeringSystem::ObstacleAvoidance( const Steering::Handle& boid ) const
 	{
 		if( Reflex::GetMagnitudeSq( boid->GetTransform()->GetVelocity() ) <= 0.0001f )
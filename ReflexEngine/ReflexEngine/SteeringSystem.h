@@ -2,6 +2,7 @@
 
 #include "System.h"
 #include "SteeringComponent.h"
+#include "FlockingKernel.h"
 
 namespace Reflex::Systems
 {
@@ -16,7 +17,8 @@ namespace Reflex::Systems
 		void Update( const float deltaTime ) final;
 
 	protected:
-		void Integrate( const Steering::Handle& boid, const float deltaTime ) const;
+		void CalculateSteering( Reflex::Components::Steering& boid, const Reflex::Components::Transform& transform ) const;
+		void Integrate( Reflex::Components::Steering& boid, Reflex::Components::Transform& transform, const float deltaTime ) const;
 		sf::Vector2f Steering( const Steering::Handle& boid ) const;
 
 		sf::Vector2f Seek( const Steering::Handle& boid, const sf::Vector2f& target ) const;
@@ -27,5 +29,12 @@ namespace Reflex::Systems
 		sf::Vector2f Evade( const Steering::Handle& boid, const Object& target ) const;
 		sf::Vector2f Flocking( const Steering::Handle& boid ) const;
 		sf::Vector2f ObstacleAvoidance( const Steering::Handle& boid ) const;
+
+		// Rebuilds the boid's cached neighbour list if it has moved more than half its skin since the last build (see Steering::CacheNeighbours)
+		void UpdateNeighbourList( const Steering::Handle& boid ) const;
+
+		// Calls f for the other boids within range (from the spatial index, or every boid when it is disabled)
+		template< typename Func >
+		void ForEachNearbyBoid( const Steering::Handle& boid, const float range, Func f ) const;
 	};
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Component.h"
 #include "Object.h"
 #include "BaseSystem.h"
+#include "View.h"
 
 namespace Reflex::Core { class World; }
 
@@ -15,6 +16,18 @@ namespace Reflex::Systems
 	GetWorld().RegisterComponent< T >(); \
 	m_requiredComponents.set( T::GetFamily() );
 
+// Declares the component types a system's Update reads from / writes to, used to schedule non-conflicting systems concurrently
+// Writing a Transform also covers its spatial index location, so only declare access that the Update actually stays within
+#define ReadsComponent( T ) \
+	GetWorld().RegisterComponent< T >(); \
+	m_readComponents.set( T::GetFamily() ); \
+	m_declaredAccess = true;
+
+#define WritesComponent( T ) \
+	GetWorld().RegisterComponent< T >(); \
+	m_writeComponents.set( T::GetFamily() ); \
+	m_declaredAccess = true;
+
 	class System : public BaseSystem
 	{
 	public:
@@ -33,18 +46,65 @@ namespace Reflex::Systems
 				f( ( object.template GetComponent< Args >() )... );
 		}
 
+		// Same as ForEachObject but the object list is split into batches across the world's job system
+		// The callback must only write to the object it was passed
+		template< typename... Args, typename Func >
+		void ParallelForEachObject( Func f, const std::size_t minBatchSize = 64 ) const;
+
 	protected:
 		virtual bool ShouldAddObject( const Object& object ) const override 
 		{ 
 			return ( object.GetComponentFlags() & GetRequiredComponents() ) == GetRequiredComponents(); 
 		}
 
-		virtual void AddComponent( const Object& object ) override
+		// Called once the object has been added to the system's object list
+		virtual void AddComponent( const Object& object ) override { }
+
+		// Membership is tracked by object index so adding, finding and removing objects is constant time
+		// Removing swaps the last object into the freed position, so the object list isn't kept in the order objects were added
+		bool HasObject( const BaseObject& object ) const
+		{
+			return object.GetIndex() < m_objectPositions.size() && m_objectPositions[object.GetIndex()] != InvalidPosition && m_releventObjects[m_objectPositions[object.GetIndex()]] == object;
+		}
+
+		void InsertObject( const Object& object )
 		{
+			if( object.GetIndex() >= m_objectPositions.size() )
+				m_objectPositions.resize( object.GetIndex() + 1, InvalidPosition );
+
+			m_objectPositions[object.GetIndex()] = ( std::uint32_t )m_releventObjects.size();
 			m_releventObjects.push_back( object );
 		}
 
+		void EraseObject( const BaseObject& object )
+		{
+			assert( HasObject( object ) );
+			const auto position = m_objectPositions[object.GetIndex()];
+
+			m_releventObjects[position] = m_releventObjects.back();
+			m_objectPositions[m_releventObjects[position].GetIndex()] = position;
+			m_objectPositions[object.GetIndex()] = InvalidPosition;
+			m_releventObjects.pop_back();
+		}
+
 	protected:
 		std::vector< Reflex::Object > m_releventObjects;
+
+	private:
+		static constexpr std::uint32_t InvalidPosition = std::numeric_limits< std::uint32_t >::max();
+
+		// Object index -> position in m_releventObjects
+		std::vector< std::uint32_t > m_objectPositions;
 	};
+
+	// Template definitions
+	template< typename... Args, typename Func >
+	void System::ParallelForEachObject( Func f, const std::size_t minBatchSize ) const
+	{
+		GetWorld().GetJobSystem().ParallelFor( m_releventObjects.size(), minBatchSize, [&]( const std::size_t begin, const std::size_t end )
+		{
+			for( auto i = begin; i < end; ++i )
+				f( ( m_releventObjects[i].template GetComponent< Args >() )... );
+		} );
+	}
 }
\ No newline at end of file
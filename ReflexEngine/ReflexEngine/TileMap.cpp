@@ -22,15 +22,14 @@ namespace Reflex::Core
 		Reset();
 	}
 
-	void TileMap::Reset()
+	void TileMap::Clear()
 	{
 		m_chunkSize = m_cellSize * m_chunkSizeInCells;
-		m_spacialChunks.clear();
-
-		Chunk newChunk;
-		newChunk.chunk = sf::Vector2i( 0, 0 );
-		newChunk.buckets.resize( m_chunkSizeInCells * m_chunkSizeInCells );
-		m_spacialChunks.push_back( newChunk );
+		m_chunkStorage.clear();
+		m_freeChunks.clear();
+		m_chunkTable.clear();
+		m_chunkCount = 0;
+		ResizeChunkTable( 64 );
 	}
 
 	void TileMap::Repopulate( World& world, const unsigned cellSize, const unsigned chunkSizeInCells )
@@ -40,38 +39,17 @@ namespace Reflex::Core
 		Repopulate( world );
 	}
 
-	void TileMap::Repopulate( World& world )
-	{
-		Reset();
-		
-		for( const auto object : world.GetObjects() )
-			Insert( object );
-	}
-
 	void TileMap::Insert( const Object& object )
 	{
 		assert( object && IsValid() );
 		if( object && IsValid() )
 		{
 			const auto position = object.GetComponent< Reflex::Components::Transform >()->GetWorldPosition();
-			const auto chunkIdx = ChunkHash( position );
 
-			auto chunk_iter = FindChunk( chunkIdx );
-			if( chunk_iter == m_spacialChunks.end() )
-			{
-				m_spacialChunks.emplace_back();
-				chunk_iter = std::prev( m_spacialChunks.end() );
-			}
-
-			auto& chunk = *chunk_iter;
-
-			if( chunk.buckets.empty() )
-				chunk.buckets.resize( m_chunkSizeInCells * m_chunkSizeInCells );
-
-			const auto cellId = GetCellId( position );
-			chunk.buckets[cellId].push_back( object );
-			chunk.totalObjects++;
-			chunk.chunk = chunkIdx;
+			sf::Vector2i chunkIdx;
+			unsigned cellId = 0U;
+			Locate( position, chunkIdx, cellId );
+			InsertAt( object, chunkIdx, cellId );
 
 #ifdef TileMapLogging
 			//LOG_INFO( "Insert Position: " << position << ", Chunk: " << chunkIdx << ", cell: " << cellId );
@@ -81,59 +59,27 @@ namespace Reflex::Core
 		}
 	}
 
-	void TileMap::Insert( const Object& object, const sf::FloatRect& boundary )
-	{
-		assert( object && IsValid() );
-		if( object && IsValid() )
-		{
-			const auto locTopLeft = CellHash( sf::Vector2f( boundary.left, boundary.top ) );
-			const auto locBotRight = CellHash( sf::Vector2f( boundary.left + boundary.width, boundary.top + boundary.height ) );
-			std::vector< unsigned > ids;
-
-			for( int x = locTopLeft.x; x <= locBotRight.x; ++x )
-			{
-				for( int y = locTopLeft.y; y <= locBotRight.y; ++y )
-				{
-					const auto chunkIdx = sf::Vector2i( x / ( int )m_chunkSizeInCells, y / ( int )m_chunkSizeInCells );
-
-					auto chunk_iter = FindChunk( chunkIdx );
-					if( chunk_iter == m_spacialChunks.end() )
-					{
-						m_spacialChunks.emplace_back();
-						chunk_iter = std::prev( m_spacialChunks.end() );
-					}
-
-					auto& chunk = *chunk_iter;
-
-					if( chunk.buckets.empty() )
-						chunk.buckets.resize( m_chunkSizeInCells * m_chunkSizeInCells );
-
-					const auto cellId = y * m_chunkSizeInCells + x;
-					chunk.buckets[cellId].push_back( object );
-					chunk.totalObjects++;
-					chunk.chunk = chunkIdx;
-#ifdef TileMapLogging
-					//LOG_INFO( "Insert Boundary: Chunk: " << chunkIdx << ", cell: " << cellId );
-					//if( auto sfmlObj = object.GetComponent< Reflex::Components::SFMLObject >() )
-					//	sfmlObj->GetCircleShape().setFillColor( Reflex::ColourFromScalar( ( std::hash< unsigned >()( cellId * 23234 ^ 345 ) % 1000 ) / 1000.0f ) );
-#endif
-				}
-			}
-		}
-	}
-
 	void TileMap::Remove( const Object& object )
 	{
 		assert( object );
 		if( object )
-			Remove( object, object.GetComponent< Reflex::Components::Transform >()->GetWorldPosition() );
+		{
+			// Removed from the cell it was last put in, which may differ from its position while moves are deferred
+			const auto& location = GetLocation( object );
+			Remove( object, location.cell, location.id );
+		}
 	}
 
 	void TileMap::Remove( const Object& object, const sf::Vector2f& position )
 	{
 		assert( object );
 		if( object )
-			Remove( object, ChunkHash( position ), GetCellId( position ) );
+		{
+			sf::Vector2i chunkIdx;
+			unsigned cellId = 0U;
+			Locate( position, chunkIdx, cellId );
+			Remove( object, chunkIdx, cellId );
+		}
 	}
 
 	void TileMap::Remove( const Object& object, const sf::Vector2i& chunkIdx, const unsigned cellId )
@@ -141,8 +87,12 @@ namespace Reflex::Core
 		assert( object && IsValid() );
 		if( object && IsValid() )
 		{
-			auto chunk_iter = FindChunk( chunkIdx );
-			auto& bucket = chunk_iter->buckets[cellId];
+			auto* chunk = FindChunk( chunkIdx );
+			assert( chunk );
+			if( !chunk )
+				return;
+
+			auto& bucket = chunk->buckets[cellId];
 
 			const auto found = std::find( bucket.begin(), bucket.end(), object );
 			assert( found != bucket.end() );
@@ -151,75 +101,66 @@ namespace Reflex::Core
 #ifdef TileMapLogging
 				//LOG_INFO( "Remove Position: " << object.GetComponent< Reflex::Components::Transform >()->GetWorldPosition() << ", Chunk: " << chunkIdx << ", cell: " << cellId );
 #endif
-				bucket.erase( found );
-				chunk_iter->totalObjects--;
+				// Order within a bucket doesn't matter, so swap and pop rather than shifting the rest down
+				*found = bucket.back();
+				bucket.pop_back();
+				chunk->totalObjects--;
 
-				if( chunk_iter->totalObjects == 0 )
-					m_spacialChunks.erase( chunk_iter );
+				if( chunk->totalObjects == 0 )
+					RemoveChunk( chunkIdx );
 			}
 		}
 	}
 
-	void TileMap::Remove( const Object& object, const sf::FloatRect& boundary )
+	void TileMap::ForEachCandidate( const sf::FloatRect& boundary, const CandidateCallback& callback ) const
 	{
-		assert( object && IsValid() );
-		if( object && IsValid() )
-		{
-			const auto locTopLeft = CellHash( sf::Vector2f( boundary.left, boundary.top ) );
-			const auto locBotRight = CellHash( sf::Vector2f( boundary.left + boundary.width, boundary.top + boundary.height ) );
-			std::vector< unsigned > ids;
+		if( !IsValid() )
+			return;
+
+		const auto locTopLeft = CellHash( sf::Vector2f( boundary.left, boundary.top ) );
+		const auto locBotRight = CellHash( sf::Vector2f( boundary.left + boundary.width, boundary.top + boundary.height ) );
 
-			for( int x = locTopLeft.x; x <= locBotRight.x; ++x )
+		for( int x = locTopLeft.x; x <= locBotRight.x; ++x )
+		{
+			for( int y = locTopLeft.y; y <= locBotRight.y; ++y )
 			{
-				for( int y = locTopLeft.y; y <= locBotRight.y; ++y )
-				{
-					const auto chunkIdx = sf::Vector2i( x / ( int )m_chunkSizeInCells, y / ( int )m_chunkSizeInCells );
-					auto chunk_iter = FindChunk( chunkIdx );
-
-					const auto cellId = y * m_chunkSizeInCells + x;
-					auto& container = chunk_iter->buckets[cellId];
-
-					const auto found = std::find( container.begin(), container.end(), object );
-					assert( found != container.end() );
-					if( found != container.end() )
-					{
-#ifdef TileMapLogging
-						//LOG_INFO( "Remove Boundary: , Chunk: " << chunkIdx << ", cell: " << cellId );
-#endif
+				sf::Vector2i chunkIdx;
+				unsigned cellId = 0U;
+				SplitCell( sf::Vector2i( x, y ), chunkIdx, cellId );
 
-						container.erase( found );
-						chunk_iter->totalObjects--;
+				const auto* chunk = FindChunk( chunkIdx );
+				if( !chunk )
+					continue;
 
-						if( chunk_iter->totalObjects == 0 )
-							m_spacialChunks.erase( chunk_iter );
-					}
-				}
+				for( const auto& obj : chunk->buckets[cellId] )
+					callback( Object( obj ) );
 			}
 		}
 	}
 
-	void TileMap::GetNearby( const Object& object, const float distance, std::vector< Object >& out ) const
+	SpatialIndexLocation TileMap::Locate( const Object& object ) const
 	{
-		ForEachInRange( object, distance, [&out]( const Object& obj )
-		{
-			out.push_back( obj );
-		} );
+		SpatialIndexLocation location;
+		Locate( object.GetTransform()->GetWorldPosition(), location.cell, location.id );
+		return location;
 	}
 
-	void TileMap::GetNearby( const sf::Vector2f& position, const float distance, std::vector< Object >& out ) const
+	void TileMap::Relocate( const Object& object, const SpatialIndexLocation& newLocation )
 	{
-		ForEachInRange( position, distance, [&out]( const Object& obj )
-		{
-			out.push_back( obj );
-		} );
+		const auto previous = GetLocation( object );
+		Remove( object, previous.cell, previous.id );
+		InsertAt( object, newLocation.cell, newLocation.id );
 	}
 
-	void TileMap::GetNearby( const sf::FloatRect& boundary, std::vector< Object >& out ) const
+	void TileMap::InsertAt( const Object& object, const sf::Vector2i& chunkIdx, const unsigned cellId )
 	{
-		ForEachInBounds( boundary, [&out]( const Object& obj )
-		{
-			out.push_back( obj );
-		} );
+		auto& chunk = FindOrCreateChunk( chunkIdx );
+		chunk.buckets[cellId].push_back( object );
+		chunk.totalObjects++;
+
+		auto& location = GetLocation( object );
+		location.cell = chunkIdx;
+		location.id = cellId;
 	}
 
 	unsigned TileMap::GetCellId( const Object& object ) const
@@ -230,10 +171,10 @@ namespace Reflex::Core
 
 	unsigned TileMap::GetCellId( const sf::Vector2f& position ) const
 	{
-		const auto chunk = ChunkHash( position );
-		const auto startPosition = Reflex::Vector2iToVector2f( chunk ) * ( float )m_chunkSize;
-		const auto loc = CellHash( position - startPosition );
-		return loc.y * m_chunkSizeInCells + loc.x;
+		sf::Vector2i chunkIdx;
+		unsigned cellId = 0U;
+		Locate( position, chunkIdx, cellId );
+		return cellId;
 	}
 
 	sf::Vector2i TileMap::CellHash( const Object& object ) const
@@ -266,17 +207,132 @@ namespace Reflex::Core
 		return Object( object ).IsValid();
 	}
 
-	sf::Vector2f TileMap::GetObjectPosition( const BaseObject& object ) const
+	void TileMap::SplitCell( const sf::Vector2i& cell, sf::Vector2i& chunkIdx, unsigned& cellId ) const
+	{
+		const auto size = ( int )m_chunkSizeInCells;
+		const auto floorDiv = [size]( const int value ) { return value >= 0 ? value / size : ( value - size + 1 ) / size; };
+
+		chunkIdx = sf::Vector2i( floorDiv( cell.x ), floorDiv( cell.y ) );
+		const auto local = cell - chunkIdx * size;
+		cellId = unsigned( local.y * size + local.x );
+	}
+
+	void TileMap::Locate( const sf::Vector2f& position, sf::Vector2i& chunkIdx, unsigned& cellId ) const
+	{
+		SplitCell( CellHash( position ), chunkIdx, cellId );
+	}
+
+	TileMap::Chunk* TileMap::FindChunk( const sf::Vector2i& chunkIdx )
+	{
+		return const_cast< Chunk* >( static_cast< const TileMap* >( this )->FindChunk( chunkIdx ) );
+	}
+
+	const TileMap::Chunk* TileMap::FindChunk( const sf::Vector2i& chunkIdx ) const
+	{
+		const auto& entry = m_chunkTable[FindTableSlot( chunkIdx )];
+		return entry.storageIndex == InvalidChunk ? nullptr : &m_chunkStorage[entry.storageIndex];
+	}
+
+	TileMap::Chunk& TileMap::FindOrCreateChunk( const sf::Vector2i& chunkIdx )
+	{
+		auto slot = FindTableSlot( chunkIdx );
+
+		if( m_chunkTable[slot].storageIndex != InvalidChunk )
+			return m_chunkStorage[m_chunkTable[slot].storageIndex];
+
+		if( ( m_chunkCount + 1 ) * 2 > m_chunkTable.size() )
+		{
+			ResizeChunkTable( m_chunkTable.size() * 2 );
+			slot = FindTableSlot( chunkIdx );
+		}
+
+		std::uint32_t storageIndex = 0;
+
+		if( !m_freeChunks.empty() )
+		{
+			storageIndex = m_freeChunks.back();
+			m_freeChunks.pop_back();
+		}
+		else
+		{
+			storageIndex = ( std::uint32_t )m_chunkStorage.size();
+			m_chunkStorage.emplace_back();
+		}
+
+		auto& chunk = m_chunkStorage[storageIndex];
+		chunk.chunk = chunkIdx;
+		chunk.totalObjects = 0;
+
+		if( chunk.buckets.empty() )
+			chunk.buckets.resize( m_chunkSizeInCells * m_chunkSizeInCells );
+
+		m_chunkTable[slot].chunk = chunkIdx;
+		m_chunkTable[slot].storageIndex = storageIndex;
+		++m_chunkCount;
+		return chunk;
+	}
+
+	void TileMap::RemoveChunk( const sf::Vector2i& chunkIdx )
 	{
-		assert( IsValid( object ) );
-		return Object( object ).GetTransform()->getPosition();
+		auto hole = FindTableSlot( chunkIdx );
+
+		if( m_chunkTable[hole].storageIndex == InvalidChunk )
+			return;
+
+		m_freeChunks.push_back( m_chunkTable[hole].storageIndex );
+		--m_chunkCount;
+
+		// Backward shift deletion, entries after the hole are moved back if the hole lies between their ideal slot and where they are now
+		// This keeps every probe sequence unbroken without tombstones
+		const auto mask = m_chunkTable.size() - 1;
+
+		for( auto next = ( hole + 1 ) & mask; m_chunkTable[next].storageIndex != InvalidChunk; next = ( next + 1 ) & mask )
+		{
+			const auto ideal = HashChunk( m_chunkTable[next].chunk );
+
+			if( ( ( next - ideal ) & mask ) >= ( ( next - hole ) & mask ) )
+			{
+				m_chunkTable[hole] = m_chunkTable[next];
+				hole = next;
+			}
+		}
+
+		m_chunkTable[hole] = ChunkTableEntry();
 	}
 
-	std::vector< TileMap::Chunk >::iterator TileMap::FindChunk( const sf::Vector2i& chunkIdx )
+	std::size_t TileMap::FindTableSlot( const sf::Vector2i& chunkIdx ) const
 	{
-		return std::find_if( m_spacialChunks.begin(), m_spacialChunks.end(), [&]( const Chunk& chunk )
+		assert( !m_chunkTable.empty() );
+		const auto mask = m_chunkTable.size() - 1;
+
+		for( auto slot = HashChunk( chunkIdx ); ; slot = ( slot + 1 ) & mask )
 		{
-			return chunk.chunk == chunkIdx;
-		} );
+			const auto& entry = m_chunkTable[slot];
+			if( entry.storageIndex == InvalidChunk || entry.chunk == chunkIdx )
+				return slot;
+		}
+	}
+
+	std::size_t TileMap::HashChunk( const sf::Vector2i& chunkIdx ) const
+	{
+		// Fibonacci hashing of both coordinates packed into 64 bits, the top bits index the table
+		const auto key = ( std::uint64_t( std::uint32_t( chunkIdx.x ) ) << 32 ) | std::uint64_t( std::uint32_t( chunkIdx.y ) );
+		return std::size_t( ( key * 0x9E3779B97F4A7C15ULL ) >> m_chunkTableShift );
+	}
+
+	void TileMap::ResizeChunkTable( const std::size_t size )
+	{
+		assert( size > 0 && ( size & ( size - 1 ) ) == 0 );
+
+		std::vector< ChunkTableEntry > previous( size );
+		previous.swap( m_chunkTable );
+
+		m_chunkTableShift = 64;
+		for( auto remaining = size; remaining > 1; remaining >>= 1 )
+			--m_chunkTableShift;
+
+		for( const auto& entry : previous )
+			if( entry.storageIndex != InvalidChunk )
+				m_chunkTable[FindTableSlot( entry.chunk )] = entry;
 	}
 }
\ No newline at end of file
@@ -2,46 +2,42 @@
 
 #include "Precompiled.h"
 #include "BaseObject.h"
+#include "SpatialIndex.h"
 
 namespace Reflex { class Object; }
 
 namespace Reflex::Core
 {
-	class TileMap : sf::NonCopyable
+	// Spatial hash of fixed size cells, grouped into chunks that are only allocated where objects are
+	// Objects are stored once, in the cell of their position (see LooseQuadTree for bounded objects)
+	class TileMap : public SpatialIndex
 	{
 		friend class Reflex::Components::Transform;
 
 	public:
 		explicit TileMap( const unsigned cellSize, const unsigned chunkSizeInCells );
 
+		using SpatialIndex::Reset;
 		void Reset( const unsigned cellSize, const unsigned chunkSizeInCells );
-		void Reset();
 
+		using SpatialIndex::Repopulate;
 		void Repopulate( World& world, const unsigned cellSize, const unsigned chunkSizeInCells );
-		void Repopulate( World& world );
 
-		void Insert( const Object& object );
-		void Insert( const Object& object, const sf::FloatRect& boundary );
+		void Insert( const Object& object ) override;
 
-		void Remove( const Object& object );
+		void Remove( const Object& object ) override;
 		void Remove( const Object& object, const sf::Vector2f& position );
 		void Remove( const Object& object, const sf::Vector2i& chunkIdx, const unsigned cellId );
-		void Remove( const Object& object, const sf::FloatRect& boundary );
 
-		void GetNearby( const Object& object, const float distance, std::vector< Object >& out ) const;
-		void GetNearby( const sf::Vector2f& position, const float distance, std::vector< Object >& out ) const;
-		void GetNearby( const sf::FloatRect& boundary, std::vector< Object >& out ) const;
-
-		template< typename Func >
-		void ForEachInRange( const BaseObject& object, const float distance, Func f ) const;
-
-		template< typename Func >
-		void ForEachInRange( const sf::Vector2f& position, const float distance, Func f ) const;
-
-		template< typename Func >
-		void ForEachInBounds( const sf::FloatRect& boundary, Func f ) const;
+		unsigned GetCellSize() const { return m_cellSize; }
+		unsigned GetChunkSizeInCells() const { return m_chunkSizeInCells; }
 
 	protected:
+		void ForEachCandidate( const sf::FloatRect& boundary, const CandidateCallback& callback ) const override;
+		SpatialIndexLocation Locate( const Object& object ) const override;
+		void Relocate( const Object& object, const SpatialIndexLocation& newLocation ) override;
+		void Clear() override;
+
 		unsigned GetCellId( const Object& obj ) const;
 		unsigned GetCellId( const sf::Vector2f& position ) const;
 
@@ -51,90 +47,54 @@ namespace Reflex::Core
 		sf::Vector2i ChunkHash( const Object& object ) const;
 		sf::Vector2i ChunkHash( const sf::Vector2f& position ) const;
 
-		sf::Vector2f GetObjectPosition( const BaseObject& object ) const;
-
 		bool IsValid() const;
 		bool IsValid( const BaseObject& obj ) const;
 
-		template< typename Func >
-		void ForEachInBoundsInternal( const sf::FloatRect& boundary, Func f ) const;
+		// Splits a global cell location into the chunk it belongs to and the cell id within that chunk (floors for negative locations)
+		void SplitCell( const sf::Vector2i& cell, sf::Vector2i& chunkIdx, unsigned& cellId ) const;
+		void Locate( const sf::Vector2f& position, sf::Vector2i& chunkIdx, unsigned& cellId ) const;
 
-	private:
-		struct Chunk;
-		std::vector< TileMap::Chunk >::iterator FindChunk( const sf::Vector2i& chunkIdx );
+		// Inserts into a single cell and records it on the object's transform
+		void InsertAt( const Object& object, const sf::Vector2i& chunkIdx, const unsigned cellId );
 
 	private:
-		unsigned m_cellSize = 0U;
-		unsigned m_chunkSizeInCells = 0U;
-		unsigned m_chunkSize = 0U;
-
 		struct Chunk
 		{
 			sf::Vector2i chunk;
 			std::vector< std::vector< BaseObject > > buckets;
 			unsigned totalObjects = 0;
 		};
-		std::vector< Chunk > m_spacialChunks;
-	};
 
-	// Template function definitions
-	template< typename Func >
-	void TileMap::ForEachInRange( const BaseObject& object, const float distance, Func f ) const
-	{
-		ForEachInRange( GetObjectPosition( object ), distance, f );
-	}
+		Chunk* FindChunk( const sf::Vector2i& chunkIdx );
+		const Chunk* FindChunk( const sf::Vector2i& chunkIdx ) const;
+		Chunk& FindOrCreateChunk( const sf::Vector2i& chunkIdx );
+		void RemoveChunk( const sf::Vector2i& chunkIdx );
 
-	template< typename Func >
-	void TileMap::ForEachInRange( const sf::Vector2f& position, const float distance, Func f ) const
-	{
-		sf::FloatRect bounds( position - sf::Vector2f( distance, distance ), sf::Vector2f( distance, distance ) * 2.0f );
-		ForEachInBoundsInternal( bounds, [&]( const Reflex::Object& object )
-		{
-			if( Reflex::GetDistanceSq( position, object.GetTransform()->getPosition() ) <= distance * distance )
-				f( object );
-		} );
-	}
+		// Returns the table slot holding chunkIdx, or the empty slot where it would be inserted
+		std::size_t FindTableSlot( const sf::Vector2i& chunkIdx ) const;
+		std::size_t HashChunk( const sf::Vector2i& chunkIdx ) const;
+		void ResizeChunkTable( const std::size_t size );
 
-	template< typename Func >
-	void TileMap::ForEachInBounds( const sf::FloatRect& boundary, Func f ) const
-	{
-		ForEachInBoundsInternal( boundary, [&]( const Reflex::Object& object )
-		{
-			if( boundary.intersects( object.GetTransform()->GetGlobalBounds() ) )
-				f( object );
-		} );
-	}
+	private:
+		unsigned m_cellSize = 0U;
+		unsigned m_chunkSizeInCells = 0U;
+		unsigned m_chunkSize = 0U;
 
-	template< typename Func >
-	void TileMap::ForEachInBoundsInternal( const sf::FloatRect& boundary, Func f ) const
-	{
-		if( IsValid() )
+		static constexpr std::uint32_t InvalidChunk = std::numeric_limits< std::uint32_t >::max();
+
+		struct ChunkTableEntry
 		{
-			const auto locTopLeft = CellHash( sf::Vector2f( boundary.left, boundary.top ) );
-			const auto locBotRight = CellHash( sf::Vector2f( boundary.left + boundary.width, boundary.top + boundary.height ) );
-			std::vector< unsigned > ids;
-
-			for( int x = locTopLeft.x; x <= locBotRight.x; ++x )
-			{
-				for( int y = locTopLeft.y; y <= locBotRight.y; ++y )
-				{
-					const auto chunkIdx = sf::Vector2i( x / ( int )m_chunkSizeInCells, y / ( int )m_chunkSizeInCells );
-					const auto chunk_iter = std::find_if( m_spacialChunks.begin(), m_spacialChunks.end(), [&]( const Chunk& chunk )
-					{
-						return chunk.chunk == chunkIdx;
-					} );
-					
-					if( chunk_iter == m_spacialChunks.end() )
-						continue;
-
-					const auto cellId = ( y % m_chunkSizeInCells ) * m_chunkSizeInCells + x % m_chunkSizeInCells;
-					//const auto& bucket = m_spacialChunks[0].buckets[cellId];
-					const auto& bucket = chunk_iter->buckets[cellId];
-
-					for( const auto& obj : bucket )
-						f( Object( obj ) );
-				}
-			}
-		}
-	}
+			sf::Vector2i chunk;
+			std::uint32_t storageIndex = InvalidChunk;
+		};
+
+		// Chunks live in a deque (stable addresses), emptied chunks go on a free list and keep their bucket allocations for reuse
+		std::deque< Chunk > m_chunkStorage;
+		std::vector< std::uint32_t > m_freeChunks;
+
+		// Open addressing (linear probing) hash table of chunk index -> chunk storage index, power of two sized and kept at most half full
+		std::vector< ChunkTableEntry > m_chunkTable;
+		std::size_t m_chunkTableShift = 0;
+		std::size_t m_chunkCount = 0;
+	};
 }
\ No newline at end of file
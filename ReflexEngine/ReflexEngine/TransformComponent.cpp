@@ -33,51 +33,37 @@ namespace Reflex::Components
 	void Transform::OnConstructionComplete()
 	{
 		if( m_useTileMap )
-			GetWorld().GetTileMap().Insert( Component::GetObject() );
+			GetWorld().GetSpatialIndex().Insert( Component::GetObject() );
 	}
 
 	void Transform::OnDestructionBegin()
 	{
+		RemoveFromHierarchy();
+
 #ifndef DISABLE_TILEMAP
 		if( m_useTileMap )
 		{
-			auto& tileMap = m_object.GetWorld().GetTileMap();
-			tileMap.Remove( Component::GetObject() );
+			auto& spatialIndex = m_object.GetWorld().GetSpatialIndex();
+			spatialIndex.Remove( Component::GetObject() );
 		}
 #endif
 	}
 
-	bool Transform::SetValue( const std::string& variable, const std::string& value )
+	Reflex::Core::FieldTable Transform::GetFields()
 	{
-		if( variable == "Position" )
-		{
-			setPosition( Reflex::FromString< sf::Vector2f >( value ) );
-			return true;
-		}
-		else if( variable == "Rotation" )
-		{
-			setRotation( Reflex::FromString< float >( value ) );
-			return true;
-		}
-		else if( variable == "Scale" )
+		static constexpr Reflex::Core::Field fields[] =
 		{
-			setScale( Reflex::FromString< sf::Vector2f >( value ) );
-			return true;
-		}
-		else if( variable == "RenderIndex" )
-		{
-			m_renderIndex = Reflex::FromString< unsigned >( value );
-			return true;
-		}
-
-		return false;
-	}
+			ReflectProperty( Transform, "Position", sf::Vector2f, component.getPosition(), component.setPosition( value ) ),
+			ReflectProperty( Transform, "Rotation", float, component.getRotation(), component.setRotation( value ) ),
+			ReflectProperty( Transform, "Scale", sf::Vector2f, component.getScale(), component.setScale( value ) ),
+			ReflectMember( Transform, "MaxVelocity", m_maxVelocity ),
+			ReflectMemberIf( Transform, "Velocity", m_velocity, !Reflex::IsDefault( component.m_velocity ) ),
+			ReflectMemberIf( Transform, "FaceMovementDirection", m_faceMovementDirection, !component.m_faceMovementDirection ),
+			// Can be loaded but isn't saved, new objects are given their own render index (world snapshots save every field)
+			ReflectMemberIf( Transform, "RenderIndex", m_renderIndex, false ),
+		};
 
-	void Transform::GetValues( std::vector< std::pair< std::string, std::string > >& values ) const
-	{
-		values.emplace_back( "Position", Reflex::ToString( getPosition() ) );
-		values.emplace_back( "Rotation", Reflex::ToString( getRotation() ) );
-		values.emplace_back( "Scale", Reflex::ToString( getScale() ) );
+		return fields;
 	}
 
 	void Transform::setPosition( float x, float y )
@@ -92,25 +78,13 @@ namespace Reflex::Components
 #ifndef DISABLE_TILEMAP
 		if( m_useTileMap )
 		{
-			auto& tileMap = GetWorld().GetTileMap();
-
-			const auto prevCellId = tileMap.GetCellId( Component::GetObject() );
-			const auto prevChunkHash = tileMap.ChunkHash( Component::GetObject() );
-
-			sf::Transformable::setPosition( position );
-
-			if( prevCellId != tileMap.GetCellId( Component::GetObject() ) ||
-				prevChunkHash != tileMap.ChunkHash( Component::GetObject() ) )
-			{
-				tileMap.Remove( Component::GetObject(), prevChunkHash, prevCellId );
-				tileMap.Insert( Component::GetObject() );
-			}
-
+			SceneNode::setPosition( position );
+			GetWorld().GetSpatialIndex().Move( Component::GetObject() );
 			return;
 		}
 #endif
 
-		sf::Transformable::setPosition( position );
+		SceneNode::setPosition( position );
 	}
 
 	void Transform::move( float offsetX, float offsetY )
@@ -125,13 +99,13 @@ namespace Reflex::Components
 
 	void Transform::setScale( const sf::Vector2f scale )
 	{
-		Transformable::setScale( scale );
+		SceneNode::setScale( scale );
 		assert( scale.x != 0.0f || scale.y != 0.0f );
 	}
 
 	void Transform::setScale( const float scaleX, const float scaleY )
 	{
-		Transformable::setScale( scaleX, scaleY );
+		SceneNode::setScale( scaleX, scaleY );
 		assert( scaleX != 0.0f || scaleY != 0.0f );
 	}
 
@@ -167,7 +141,7 @@ namespace Reflex::Components
 		m_renderIndex = GetLayer() * 10000 + renderIndex;
 
 		if( Component::GetObject().IsFlagSet( ObjectFlags::ConstructionComplete ) )
-			GetWorld().GetEventManager().Emit( *this, RenderIndexChangedEvent{ Component::GetObject(), m_renderIndex } );
+			GetWorld().GetEventManager().Queue( *this, RenderIndexChangedEvent{ Component::GetObject(), m_renderIndex } );
 	}
 
 	void Transform::IncrementZOrder()
@@ -181,7 +155,7 @@ namespace Reflex::Components
 		m_renderIndex = layerIndex * 10000 + idx;
 
 		if( Component::GetObject().IsFlagSet( ObjectFlags::ConstructionComplete ) )
-			GetWorld().GetEventManager().Emit( *this, RenderIndexChangedEvent{ Component::GetObject(), m_renderIndex } );
+			GetWorld().GetEventManager().Queue( *this, RenderIndexChangedEvent{ Component::GetObject(), m_renderIndex } );
 	}
 
 	unsigned Transform::GetLayer() const
@@ -212,6 +186,10 @@ namespace Reflex::Components
 	void Transform::SetLocalBounds( const Reflex::BoundingBox& bounds )
 	{
 		localBounds = bounds;
+
+		// Indices that store bounds (LooseQuadTree) need to know the size changed
+		if( m_useTileMap )
+			GetWorld().GetSpatialIndex().Move( Component::GetObject() );
 	}
 
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "SceneNode.h"
 #include "MovementSystem.h"
 #include "Events.h"
+#include "SpatialIndex.h"
 
 namespace Reflex::Components
 {
@@ -13,6 +14,7 @@ namespace Reflex::Components
 	{
 	public:
 		friend class Reflex::Systems::MovementSystem;
+		friend class Reflex::Core::SpatialIndex;
 		friend class Grid;
 
 		Transform( const Reflex::Object& owner, const sf::Vector2f& position = {}, const float rotation = 0.0f, const sf::Vector2f & scale = sf::Vector2f( 1.0f, 1.0f ), const bool useTileMap = true );
@@ -21,10 +23,8 @@ namespace Reflex::Components
 		void OnConstructionComplete();
 		void OnDestructionBegin() override;
 
-		bool SetValue( const std::string& variable, const std::string& value ) override;
-		void GetValues( std::vector< std::pair< std::string, std::string > >& values ) const override;
 		static std::string GetComponentName() { return "Transform"; }
-		static void RegisterSerialisedValues() {}
+		static Reflex::Core::FieldTable GetFields();
 
 		void setPosition( float x, float y );
 		void setPosition( const sf::Vector2f& position );
@@ -55,7 +55,8 @@ namespace Reflex::Components
 
 		struct RenderIndexChangedEvent
 		{
-			const Object& object;
+			// Held by value as the event is queued (see EventManager::Queue)
+			Object object;
 			unsigned renderIdx = 0;
 		};
 
@@ -66,6 +67,9 @@ namespace Reflex::Components
 		bool FacesMovementDirection() const { return m_faceMovementDirection; }
 		void SetFaceMovementDirection( const bool faceMovement ) { m_faceMovementDirection = faceMovement; }
 
+		// Set on construction, whether the object is stored in the world's spatial index
+		bool UsesTileMap() const { return m_useTileMap; }
+
 	protected:
 		unsigned m_renderIndex = 0U;
 		static unsigned s_nextRenderIndex;
@@ -78,5 +82,9 @@ namespace Reflex::Components
 		sf::Vector2f m_velocity = sf::Vector2f( 0.0f, 0.0f );
 		float m_maxVelocity = 150.0f;
 		Reflex::BoundingBox localBounds;
+
+		// Where this transform is stored in the world's spatial index (kept by the index so moves don't have to search for the previous location)
+		Reflex::Core::SpatialIndexLocation m_spatialIndexLocation;
+		bool m_spatialIndexDirty = false;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,396 @@
+#include "Precompiled.h"
+#include "TransformHierarchy.h"
+#include "Logging.h"
+#include <array>
+
+namespace Reflex::Core
+{
+	void TransformHierarchy::Add( const BaseObject& object )
+	{
+		assert( GetNode( object ) == InvalidNode );
+
+		const auto node = ( std::uint32_t )m_owners.size();
+
+		m_owners.push_back( object );
+		m_alive.push_back( 1 );
+		m_parents.push_back( InvalidNode );
+		m_subtreeSizes.push_back( 1U );
+
+		m_localTransforms.emplace_back();
+		m_localPositions.emplace_back();
+		m_localRotations.push_back( 0.0f );
+		m_localScales.emplace_back( 1.0f, 1.0f );
+
+		m_worldTransforms.emplace_back();
+		m_worldTranslations.emplace_back();
+		m_worldRotations.push_back( 0.0f );
+		m_worldScales.emplace_back( 1.0f, 1.0f );
+		m_dirty.push_back( 0 );
+
+		if( object.GetIndex() >= m_objectToNode.size() )
+			m_objectToNode.resize( object.GetIndex() + 1, InvalidNode );
+
+		m_objectToNode[object.GetIndex()] = node;
+	}
+
+	void TransformHierarchy::Remove( const BaseObject& object )
+	{
+		const auto node = GetNode( object );
+		if( node == InvalidNode )
+			return;
+
+		// Children are split off as roots first, so the removed node is left as a leaf
+		const auto descendants = m_subtreeSizes[node] - 1;
+
+		if( descendants > 0 )
+		{
+			auto first = node + 1;
+			m_subtreeSizes[node] = 1U;
+
+			// A root's range has no ancestors to keep contiguous, otherwise the descendants are moved to the end
+			if( m_parents[node] != InvalidNode )
+			{
+				AddToAncestorSizes( m_parents[node], -( int )descendants );
+				first = MoveRange( first, descendants, ( std::uint32_t )m_owners.size() );
+			}
+
+			for( auto child = first; child < first + descendants; child += m_subtreeSizes[child] )
+			{
+				m_parents[child] = InvalidNode;
+				MarkDirty( child );
+			}
+		}
+
+		m_alive[node] = 0;
+		m_dirty[node] = 0;
+		m_owners[node] = BaseObject();
+		m_objectToNode[object.GetIndex()] = InvalidNode;
+		++m_deadCount;
+	}
+
+	void TransformHierarchy::Attach( const BaseObject& child, const BaseObject& parent )
+	{
+		auto node = GetNode( child );
+		const auto parentNode = GetNode( parent );
+		assert( node != InvalidNode && parentNode != InvalidNode );
+
+		if( node == InvalidNode || parentNode == InvalidNode )
+			return;
+
+		if( IsDescendantOf( parent, child ) || parent == child )
+		{
+			LOG_CRIT( "Cannot attach a node to itself or one of its descendants" );
+			return;
+		}
+
+		const auto size = m_subtreeSizes[node];
+		const auto insertBefore = parentNode + m_subtreeSizes[parentNode];
+
+		if( m_parents[node] != InvalidNode )
+			AddToAncestorSizes( m_parents[node], -( int )size );
+
+		node = MoveSubtree( node, insertBefore );
+
+		// The parent may have shifted with the move
+		const auto newParent = GetNode( parent );
+		m_parents[node] = newParent;
+		AddToAncestorSizes( newParent, ( int )size );
+		MarkDirty( node );
+	}
+
+	void TransformHierarchy::Detach( const BaseObject& child )
+	{
+		auto node = GetNode( child );
+		if( node == InvalidNode || m_parents[node] == InvalidNode )
+			return;
+
+		AddToAncestorSizes( m_parents[node], -( int )m_subtreeSizes[node] );
+		m_parents[node] = InvalidNode;
+		node = MoveSubtree( node, ( std::uint32_t )m_owners.size() );
+		MarkDirty( node );
+	}
+
+	void TransformHierarchy::SetLocal( const BaseObject& object, const sf::Transformable& local )
+	{
+		const auto node = GetNode( object );
+		if( node == InvalidNode )
+			return;
+
+		m_localTransforms[node] = local.getTransform();
+		m_localPositions[node] = local.getPosition();
+		m_localRotations[node] = local.getRotation();
+		m_localScales[node] = local.getScale();
+		MarkDirty( node );
+	}
+
+	BaseObject TransformHierarchy::GetParent( const BaseObject& object ) const
+	{
+		const auto node = GetNode( object );
+		if( node == InvalidNode || m_parents[node] == InvalidNode )
+			return BaseObject();
+
+		return m_owners[m_parents[node]];
+	}
+
+	unsigned TransformHierarchy::GetChildrenCount( const BaseObject& object ) const
+	{
+		unsigned count = 0U;
+		ForEachChild( object, [&count]( const BaseObject& ) { ++count; } );
+		return count;
+	}
+
+	BaseObject TransformHierarchy::GetChild( const BaseObject& object, const unsigned index ) const
+	{
+		BaseObject result;
+		unsigned current = 0U;
+
+		ForEachChild( object, [&]( const BaseObject& child )
+		{
+			if( current++ == index )
+				result = child;
+		} );
+
+		return result;
+	}
+
+	bool TransformHierarchy::IsDescendantOf( const BaseObject& object, const BaseObject& ancestor ) const
+	{
+		const auto node = GetNode( object );
+		const auto ancestorNode = GetNode( ancestor );
+
+		if( node == InvalidNode || ancestorNode == InvalidNode )
+			return false;
+
+		return node > ancestorNode && node < ancestorNode + m_subtreeSizes[ancestorNode];
+	}
+
+	sf::Transform TransformHierarchy::GetWorldTransform( const BaseObject& object ) const
+	{
+		const auto node = GetNode( object );
+		if( node == InvalidNode )
+			return sf::Transform();
+
+		UpdateWorldTransform( node );
+		return m_worldTransforms[node];
+	}
+
+	sf::Vector2f TransformHierarchy::GetWorldTranslation( const BaseObject& object ) const
+	{
+		const auto node = GetNode( object );
+		if( node == InvalidNode )
+			return sf::Vector2f();
+
+		UpdateWorldTransform( node );
+		return m_worldTranslations[node];
+	}
+
+	float TransformHierarchy::GetWorldRotation( const BaseObject& object ) const
+	{
+		const auto node = GetNode( object );
+		if( node == InvalidNode )
+			return 0.0f;
+
+		UpdateWorldTransform( node );
+		return m_worldRotations[node];
+	}
+
+	sf::Vector2f TransformHierarchy::GetWorldScale( const BaseObject& object ) const
+	{
+		const auto node = GetNode( object );
+		if( node == InvalidNode )
+			return sf::Vector2f( 1.0f, 1.0f );
+
+		UpdateWorldTransform( node );
+		return m_worldScales[node];
+	}
+
+	void TransformHierarchy::UpdateWorldTransforms()
+	{
+		if( m_deadCount > 0 && m_deadCount * 4 >= m_owners.size() )
+			Compact();
+
+		const auto count = ( std::uint32_t )m_owners.size();
+
+		for( auto node = std::min( m_firstDirty, count ); node < count; ++node )
+		{
+			if( !m_dirty[node] )
+				continue;
+
+			ComputeWorldTransform( node );
+			m_dirty[node] = 0;
+		}
+
+		m_firstDirty = InvalidNode;
+	}
+
+	std::uint32_t TransformHierarchy::GetNode( const BaseObject& object ) const
+	{
+		if( object.GetIndex() >= m_objectToNode.size() )
+			return InvalidNode;
+
+		const auto node = m_objectToNode[object.GetIndex()];
+		return node != InvalidNode && m_owners[node] == object ? node : InvalidNode;
+	}
+
+	void TransformHierarchy::MarkDirty( const std::uint32_t node )
+	{
+		if( m_dirty[node] )
+			return;
+
+		std::fill( m_dirty.begin() + node, m_dirty.begin() + node + m_subtreeSizes[node], char( 1 ) );
+		m_firstDirty = std::min( m_firstDirty, node );
+	}
+
+	void TransformHierarchy::UpdateWorldTransform( const std::uint32_t node ) const
+	{
+		if( !m_dirty[node] )
+			return;
+
+		// Walk up to the first clean ancestor then recompute back down, the chain is kept on the stack
+		// Deeper chains update the part above the stack first (one call per 32 levels)
+		std::array< std::uint32_t, 32 > chain;
+		std::size_t length = 0;
+		auto current = node;
+
+		for( ; current != InvalidNode && m_dirty[current] && length < chain.size(); current = m_parents[current] )
+			chain[length++] = current;
+
+		if( current != InvalidNode && m_dirty[current] )
+			UpdateWorldTransform( current );
+
+		while( length > 0 )
+		{
+			const auto next = chain[--length];
+			ComputeWorldTransform( next );
+			m_dirty[next] = 0;
+		}
+	}
+
+	void TransformHierarchy::ComputeWorldTransform( const std::uint32_t node ) const
+	{
+		const auto parent = m_parents[node];
+
+		if( parent == InvalidNode )
+		{
+			m_worldTransforms[node] = m_localTransforms[node];
+			m_worldTranslations[node] = m_localPositions[node];
+			m_worldRotations[node] = m_localRotations[node];
+			m_worldScales[node] = m_localScales[node];
+			return;
+		}
+
+		m_worldTransforms[node] = m_worldTransforms[parent] * m_localTransforms[node];
+		m_worldTranslations[node] = m_worldTranslations[parent] + m_localPositions[node];
+		m_worldRotations[node] = m_worldRotations[parent] + m_localRotations[node];
+		m_worldScales[node] = sf::Vector2f( m_worldScales[parent].x * m_localScales[node].x, m_worldScales[parent].y * m_localScales[node].y );
+	}
+
+	std::uint32_t TransformHierarchy::MoveSubtree( const std::uint32_t node, const std::uint32_t insertBefore )
+	{
+		return MoveRange( node, m_subtreeSizes[node], insertBefore );
+	}
+
+	std::uint32_t TransformHierarchy::MoveRange( const std::uint32_t start, const std::uint32_t size, const std::uint32_t insertBefore )
+	{
+		if( insertBefore == start || insertBefore == start + size )
+			return start;
+
+		assert( insertBefore < start || insertBefore > start + size );
+
+		const auto first = std::min( start, insertBefore );
+		const auto middle = insertBefore > start ? start + size : start;
+		const auto last = insertBefore > start ? insertBefore : start + size;
+
+		Rotate( m_owners, first, middle, last );
+		Rotate( m_alive, first, middle, last );
+		Rotate( m_parents, first, middle, last );
+		Rotate( m_subtreeSizes, first, middle, last );
+		Rotate( m_localTransforms, first, middle, last );
+		Rotate( m_localPositions, first, middle, last );
+		Rotate( m_localRotations, first, middle, last );
+		Rotate( m_localScales, first, middle, last );
+		Rotate( m_worldTransforms, first, middle, last );
+		Rotate( m_worldTranslations, first, middle, last );
+		Rotate( m_worldRotations, first, middle, last );
+		Rotate( m_worldScales, first, middle, last );
+		Rotate( m_dirty, first, middle, last );
+
+		// std::rotate moves [middle, last) to first and [first, middle) after it
+		const auto remap = [&]( const std::uint32_t index )
+		{
+			if( index == InvalidNode || index < first || index >= last )
+				return index;
+
+			return index < middle ? index + ( last - middle ) : index - ( middle - first );
+		};
+
+		// Parents outside of the moved range can still point into it, nodes before first are untouched as pre-order keeps their parents before them
+		for( auto node = first; node < m_parents.size(); ++node )
+			m_parents[node] = remap( m_parents[node] );
+
+		for( auto moved = first; moved < last; ++moved )
+			if( IsAlive( moved ) )
+				m_objectToNode[m_owners[moved].GetIndex()] = moved;
+
+		m_firstDirty = std::min( m_firstDirty, first );
+		return remap( start );
+	}
+
+	void TransformHierarchy::AddToAncestorSizes( const std::uint32_t node, const int delta )
+	{
+		for( auto current = node; current != InvalidNode; current = m_parents[current] )
+			m_subtreeSizes[current] = std::uint32_t( int( m_subtreeSizes[current] ) + delta );
+	}
+
+	void TransformHierarchy::Compact()
+	{
+		std::vector< std::uint32_t > newIndices( m_owners.size(), InvalidNode );
+		std::uint32_t count = 0U;
+
+		for( std::uint32_t node = 0U; node < m_owners.size(); ++node )
+			if( IsAlive( node ) )
+				newIndices[node] = count++;
+
+		// Stable, so parents stay before their children
+		const auto compact = [&]( auto& values )
+		{
+			for( std::uint32_t node = 0U; node < newIndices.size(); ++node )
+				if( newIndices[node] != InvalidNode )
+					values[newIndices[node]] = values[node];
+
+			values.resize( count );
+		};
+
+		compact( m_owners );
+		compact( m_alive );
+		compact( m_parents );
+		compact( m_localTransforms );
+		compact( m_localPositions );
+		compact( m_localRotations );
+		compact( m_localScales );
+		compact( m_worldTransforms );
+		compact( m_worldTranslations );
+		compact( m_worldRotations );
+		compact( m_worldScales );
+		compact( m_dirty );
+
+		// Removed nodes never have children, so live parents are always kept
+		m_subtreeSizes.assign( count, 1U );
+		m_firstDirty = InvalidNode;
+
+		for( std::uint32_t node = 0U; node < count; ++node )
+		{
+			m_parents[node] = m_parents[node] == InvalidNode ? InvalidNode : newIndices[m_parents[node]];
+			m_objectToNode[m_owners[node].GetIndex()] = node;
+
+			if( m_dirty[node] )
+				m_firstDirty = std::min( m_firstDirty, node );
+		}
+
+		for( auto node = count; node-- > 0; )
+			if( m_parents[node] != InvalidNode )
+				m_subtreeSizes[m_parents[node]] += m_subtreeSizes[node];
+
+		m_deadCount = 0;
+	}
+}
\ No newline at end of file
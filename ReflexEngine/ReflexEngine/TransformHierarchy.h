@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "BaseObject.h"
+
+namespace Reflex::Core
+{
+	// Flat storage of the scene graph, one node per transform sorted so every subtree is a contiguous range after its root (pre-order)
+	// Local and world values are stored in separate arrays with parent indices, so refreshing world transforms is a single linear sweep
+	// where a node's parent has always been updated before it. Attach / Detach move a subtree's range to keep the ordering
+	// Removed nodes are left as dead slots and compacted away once enough have built up
+	class TransformHierarchy : private sf::NonCopyable
+	{
+	public:
+		static constexpr std::uint32_t InvalidNode = std::numeric_limits< std::uint32_t >::max();
+
+		// New nodes are roots with an identity transform
+		void Add( const BaseObject& object );
+		// Children of a removed node become roots
+		void Remove( const BaseObject& object );
+
+		// Moves the child (and its subtree) to be the last child of parent
+		void Attach( const BaseObject& child, const BaseObject& parent );
+		// Makes the object a root
+		void Detach( const BaseObject& child );
+
+		// Stores the local values of a transform and marks it and its subtree dirty
+		void SetLocal( const BaseObject& object, const sf::Transformable& local );
+
+		BaseObject GetParent( const BaseObject& object ) const;
+		unsigned GetChildrenCount( const BaseObject& object ) const;
+		BaseObject GetChild( const BaseObject& object, const unsigned index ) const;
+		bool IsDescendantOf( const BaseObject& object, const BaseObject& ancestor ) const;
+
+		template< typename Func >
+		void ForEachChild( const BaseObject& object, Func function ) const;
+
+		// Calls function( object, parent ) for every node in pre-order (parents before their children), parent is a null object for roots
+		template< typename Func >
+		void ForEachNode( Func function ) const;
+
+		// World values are refreshed lazily if the node is dirty (walks up to the first clean ancestor)
+		sf::Transform GetWorldTransform( const BaseObject& object ) const;
+		sf::Vector2f GetWorldTranslation( const BaseObject& object ) const;
+		float GetWorldRotation( const BaseObject& object ) const;
+		sf::Vector2f GetWorldScale( const BaseObject& object ) const;
+
+		// Refreshes every dirty node in one sweep from the first dirty node
+		void UpdateWorldTransforms();
+
+		std::size_t GetNodeCount() const { return m_owners.size() - m_deadCount; }
+
+	protected:
+		std::uint32_t GetNode( const BaseObject& object ) const;
+		bool IsAlive( const std::uint32_t node ) const { return m_alive[node] != 0; }
+
+		// Marks the node's range dirty, a dirty node's subtree is always dirty too (nodes are only cleaned after their parent)
+		void MarkDirty( const std::uint32_t node );
+		void UpdateWorldTransform( const std::uint32_t node ) const;
+		void ComputeWorldTransform( const std::uint32_t node ) const;
+
+		// Moves the range [node, node + size) so it starts at insertBefore (or ends there when moving forwards), returns the node's new index
+		std::uint32_t MoveSubtree( const std::uint32_t node, const std::uint32_t insertBefore );
+		std::uint32_t MoveRange( const std::uint32_t start, const std::uint32_t size, const std::uint32_t insertBefore );
+		void AddToAncestorSizes( const std::uint32_t node, const int delta );
+		void Compact();
+
+	private:
+		template< typename T >
+		static void Rotate( std::vector< T >& values, const std::uint32_t first, const std::uint32_t middle, const std::uint32_t last );
+
+		// Node data, all indexed by node
+		std::vector< BaseObject > m_owners;
+		std::vector< char > m_alive;
+		std::vector< std::uint32_t > m_parents;
+		std::vector< std::uint32_t > m_subtreeSizes;
+
+		std::vector< sf::Transform > m_localTransforms;
+		std::vector< sf::Vector2f > m_localPositions;
+		std::vector< float > m_localRotations;
+		std::vector< sf::Vector2f > m_localScales;
+
+		// World values are refreshed from const getters, so these are mutable
+		mutable std::vector< sf::Transform > m_worldTransforms;
+		mutable std::vector< sf::Vector2f > m_worldTranslations;
+		mutable std::vector< float > m_worldRotations;
+		mutable std::vector< sf::Vector2f > m_worldScales;
+		mutable std::vector< char > m_dirty;
+
+		// Object index -> node
+		std::vector< std::uint32_t > m_objectToNode;
+
+		std::uint32_t m_firstDirty = InvalidNode;
+		std::size_t m_deadCount = 0;
+	};
+
+	// Template definitions
+	template< typename Func >
+	void TransformHierarchy::ForEachChild( const BaseObject& object, Func function ) const
+	{
+		const auto node = GetNode( object );
+		if( node == InvalidNode )
+			return;
+
+		// Direct children start each of the sub-ranges inside this node's range
+		const auto end = node + m_subtreeSizes[node];
+
+		for( auto child = node + 1; child < end; child += m_subtreeSizes[child] )
+			if( IsAlive( child ) )
+				function( m_owners[child] );
+	}
+
+	template< typename Func >
+	void TransformHierarchy::ForEachNode( Func function ) const
+	{
+		for( std::uint32_t node = 0; node < m_owners.size(); ++node )
+			if( IsAlive( node ) )
+				function( m_owners[node], m_parents[node] == InvalidNode ? BaseObject() : m_owners[m_parents[node]] );
+	}
+
+	template< typename T >
+	void TransformHierarchy::Rotate( std::vector< T >& values, const std::uint32_t first, const std::uint32_t middle, const std::uint32_t last )
+	{
+		std::rotate( values.begin() + first, values.begin() + middle, values.begin() + last );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "World.h"
+
+namespace Reflex::Core
+{
+	// Iterates every object that has all of the template component types, passing raw component references to the callback
+	// Allocator chunk base pointers are resolved once per chunk and the object masks are checked in one linear pass,
+	// so there is no Handle / World::ObjectGetComponent lookup per component access
+	// Components of the viewed types must not be added or removed while iterating
+	template< class... Components >
+	class View
+	{
+	public:
+		explicit View( World& world );
+
+		// Calls function( Components&... ) for every matching object
+		template< typename Func >
+		void ForEach( Func function ) const;
+
+		// Same as ForEach but the iteration range is split into batches across the job system
+		// The callback must only write to the components it was passed
+		template< typename Func >
+		void ParallelForEach( JobSystem& jobSystem, Func function, const std::size_t minBatchSize = 64 ) const;
+
+		ComponentsMask GetMask() const { return m_mask; }
+
+	private:
+		template< class T >
+		static ComponentAllocatorBase* FindAllocator( World& world );
+
+		// Returns the smallest packed allocator to drive iteration from, or nullptr to sweep the object index space
+		const ComponentAllocatorBase* FindDriver() const;
+		bool HasAllAllocators() const;
+		std::size_t GetIterationCount( const ComponentAllocatorBase* driver ) const;
+
+		template< typename Func >
+		void ForEachInRange( const ComponentAllocatorBase* driver, const std::size_t begin, const std::size_t end, Func& function ) const;
+
+		template< typename Func, std::size_t... Is >
+		void ForEachChunked( const std::size_t begin, const std::size_t end, Func& function, std::index_sequence< Is... > ) const;
+
+		template< typename Func, std::size_t... Is >
+		void ForEachFromPacked( const ComponentAllocatorBase& driver, const std::size_t begin, const std::size_t end, Func& function, std::index_sequence< Is... > ) const;
+
+	private:
+		World& m_world;
+		ComponentsMask m_mask;
+		std::array< ComponentAllocatorBase*, sizeof...( Components ) > m_allocators;
+	};
+
+	// Template definitions
+	template< class... Components >
+	View< Components... > World::GetView()
+	{
+		return View< Components... >( *this );
+	}
+
+	template< class... Components >
+	View< Components... >::View( World& world )
+		: m_world( world )
+		, m_allocators{ FindAllocator< Components >( world )... }
+	{
+		( m_mask.set( Components::GetFamily() ), ... );
+	}
+
+	template< class... Components >
+	template< class T >
+	ComponentAllocatorBase* View< Components... >::FindAllocator( World& world )
+	{
+		const auto family = T::GetFamily();
+		return family < world.m_components.size() ? world.m_components[family].get() : nullptr;
+	}
+
+	template< class... Components >
+	template< typename Func >
+	void View< Components... >::ForEach( Func function ) const
+	{
+		// A component type that has never been registered can't be on any object
+		if( !HasAllAllocators() )
+			return;
+
+		const auto* driver = FindDriver();
+		ForEachInRange( driver, 0, GetIterationCount( driver ), function );
+	}
+
+	template< class... Components >
+	template< typename Func >
+	void View< Components... >::ParallelForEach( JobSystem& jobSystem, Func function, const std::size_t minBatchSize ) const
+	{
+		if( !HasAllAllocators() )
+			return;
+
+		const auto* driver = FindDriver();
+		jobSystem.ParallelFor( GetIterationCount( driver ), minBatchSize, [&]( const std::size_t begin, const std::size_t end )
+		{
+			ForEachInRange( driver, begin, end, function );
+		} );
+	}
+
+	template< class... Components >
+	bool View< Components... >::HasAllAllocators() const
+	{
+		for( const auto* allocator : m_allocators )
+			if( !allocator )
+				return false;
+		return true;
+	}
+
+	template< class... Components >
+	const ComponentAllocatorBase* View< Components... >::FindDriver() const
+	{
+		// Drive iteration from the smallest packed allocator if there is one (only live components are visited),
+		// otherwise sweep the object index space chunk by chunk
+		const ComponentAllocatorBase* driver = nullptr;
+
+		for( const auto* allocator : m_allocators )
+			if( allocator->IsPacked() && ( !driver || allocator->GetCount() < driver->GetCount() ) )
+				driver = allocator;
+
+		return driver;
+	}
+
+	template< class... Components >
+	std::size_t View< Components... >::GetIterationCount( const ComponentAllocatorBase* driver ) const
+	{
+		return driver ? driver->GetCount() : m_world.m_objects.components.size();
+	}
+
+	template< class... Components >
+	template< typename Func >
+	void View< Components... >::ForEachInRange( const ComponentAllocatorBase* driver, const std::size_t begin, const std::size_t end, Func& function ) const
+	{
+		if( driver )
+			ForEachFromPacked( *driver, begin, end, function, std::index_sequence_for< Components... >() );
+		else
+			ForEachChunked( begin, end, function, std::index_sequence_for< Components... >() );
+	}
+
+	template< class... Components >
+	template< typename Func, std::size_t... Is >
+	void View< Components... >::ForEachChunked( const std::size_t begin, const std::size_t end, Func& function, std::index_sequence< Is... > ) const
+	{
+		const auto& masks = m_world.m_objects.components;
+		const auto chunkSize = m_allocators[0]->GetChunkSize();
+		assert( ( ( m_allocators[Is]->GetChunkSize() == chunkSize ) && ... ) );
+
+		for( std::size_t start = begin; start < end; )
+		{
+			const auto chunk = start / chunkSize;
+			const auto chunkEnd = std::min( end, ( chunk + 1 ) * chunkSize );
+
+			// Chunks are only allocated once an object index reaches them, a missing chunk means no object in this range has the component
+			if( ( ( chunk < m_allocators[Is]->GetChunkCount() ) && ... ) )
+			{
+				const auto bases = std::make_tuple( static_cast< Components* >( m_allocators[Is]->GetChunkData( chunk ) )... );
+				const auto chunkStart = chunk * chunkSize;
+
+				for( auto i = start; i < chunkEnd; ++i )
+					if( ( masks[i] & m_mask ) == m_mask )
+						function( std::get< Is >( bases )[i - chunkStart]... );
+			}
+
+			start = chunkEnd;
+		}
+	}
+
+	template< class... Components >
+	template< typename Func, std::size_t... Is >
+	void View< Components... >::ForEachFromPacked( const ComponentAllocatorBase& driver, const std::size_t begin, const std::size_t end, Func& function, std::index_sequence< Is... > ) const
+	{
+		const auto& masks = m_world.m_objects.components;
+
+		for( std::size_t slot = begin; slot < end; ++slot )
+		{
+			const auto index = driver.GetSlotObjectIndex( slot );
+			if( ( masks[index] & m_mask ) == m_mask )
+				function( *static_cast< Components* >( m_allocators[Is]->Get( index ) )... );
+		}
+	}
+}
\ No newline at end of file
@@ -1,13 +1,51 @@
 #include "Precompiled.h"
 #include "Include.h"
+#include "BinaryStream.h"
 
 namespace Reflex::Core
 {
-	World::World( const Context& context, const sf::FloatRect& worldBounds, const sf::Vector2f& gravity )
+	namespace
+	{
+		const std::string& GetStageProfileName( const Reflex::Systems::SystemStage stage )
+		{
+			static const auto profileNames = []()
+			{
+				std::array< std::string, ( size_t )Reflex::Systems::SystemStage::NumStages > names;
+				for( size_t i = 0; i < names.size(); ++i )
+					names[i] = std::string( "World::Update::" ) + Reflex::Systems::GetSystemStageName( ( Reflex::Systems::SystemStage )i );
+				return names;
+			}();
+
+			return profileNames[( size_t )stage];
+		}
+
+		constexpr std::uint32_t SnapshotMagic = 0x53535752; // "RWSS"
+		constexpr std::uint32_t SnapshotVersion = 1U;
+		constexpr std::uint32_t InvalidSnapshotIndex = std::numeric_limits< std::uint32_t >::max();
+
+		// A transform in the snapshot's scene graph
+		struct SnapshotNode
+		{
+			std::uint32_t object = InvalidSnapshotIndex;
+			std::uint32_t parent = InvalidSnapshotIndex;
+			std::uint32_t useTileMap = 0U;
+		};
+
+		// A component family in a snapshot, resolved to the world's family and fields (fields the component no longer has are skipped)
+		struct SnapshotFamily
+		{
+			std::optional< std::size_t > family;
+			std::vector< FieldType > types;
+			std::vector< const Field* > fields;
+		};
+	}
+
+	World::World( const Context& context, const sf::FloatRect& worldBounds, const sf::Vector2f& gravity, const int workerThreads )
 		: m_context( context )
 		, m_worldView( context.window.getDefaultView() )
 		, m_worldBounds( worldBounds )
-		, m_tileMap( 200, 20 )
+		, m_jobSystem( workerThreads )
+		, m_spatialIndex( std::make_unique< TileMap >( 200, 20 ) )
 		, m_box2DWorld( std::make_unique< b2World >( b2Vec2( gravity.x, gravity.y ) ) )
 		, m_box2DDebugDraw( context.window, m_box2DUnitToPixelScale )
 	{
@@ -31,53 +69,122 @@ namespace Reflex::Core
 		RegisterComponent< Reflex::Components::Text >();
 		RegisterComponent< Reflex::Components::Grid >();
 		RegisterComponent< Reflex::Components::Camera >();
-		RegisterComponent< Reflex::Components::Steering >();
+		RegisterComponent< Reflex::Components::Steering >( ComponentStorage::Packed );
 		RegisterComponent< Reflex::Components::RigidBody >();
 		RegisterComponent< Reflex::Components::CircleCollider >();
 
-		AddSystem< Reflex::Systems::RenderSystem >();
-		AddSystem< Reflex::Systems::InteractableSystem >();
-		AddSystem< Reflex::Systems::MovementSystem >();
-		AddSystem< Reflex::Systems::CameraSystem >();
-		AddSystem< Reflex::Systems::SteeringSystem >();
-		AddSystem< Reflex::Systems::PhysicsSystem >();
+		// Steering sets velocities before movement integrates them, physics then syncs rigid bodies last so the Box2D result is what the frame ends with
+		using Reflex::Systems::SystemStage;
+		AddSystemToStage< Reflex::Systems::InteractableSystem >( SystemStage::PrePhysics, 0 );
+		AddSystemToStage< Reflex::Systems::SteeringSystem >( SystemStage::PrePhysics, 10 );
+		AddSystemToStage< Reflex::Systems::MovementSystem >( SystemStage::PrePhysics, 20 );
+		AddSystemToStage< Reflex::Systems::PhysicsSystem >( SystemStage::Physics, 0 );
+		AddSystemToStage< Reflex::Systems::CameraSystem >( SystemStage::RenderPrep, 0 );
+		AddSystemToStage< Reflex::Systems::RenderSystem >( SystemStage::RenderPrep, 10 );
 
 		m_sceneGraphRoot = CreateObject( sf::Vector2f( 0.0f, 0.0f ), 0.0f, sf::Vector2f( 1.0f, 1.0f ), false, false );
 
 		m_box2DDebugDraw.SetFlags( -1 );
 		m_box2DWorld->SetDebugDraw( &m_box2DDebugDraw );
 		//m_box2DWorld.SetDestructionListener( &m_destructionListener );
-		//m_box2DWorld.SetContactListener( this );
+		m_box2DWorld->SetContactListener( &m_contactListener );
 	}
 
 	void World::Update( const float deltaTime )
 	{
 		PROFILE;
 		m_deltaTime = deltaTime;
-		m_box2DWorld->Step( deltaTime, m_box2DVelocityIterations, m_box2DPositionIterations );
 
-		// Update systems
-		for( auto& system : m_systems )
-			system.second->Update( deltaTime );
+		for( unsigned stage = 0; stage < ( unsigned )Reflex::Systems::SystemStage::NumStages; ++stage )
+			UpdateStage( ( Reflex::Systems::SystemStage )stage, deltaTime );
+	}
+
+	void World::UpdateStage( const Reflex::Systems::SystemStage stage, const float deltaTime )
+	{
+#ifdef PROFILING
+		// Each stage is profiled separately so it can be budgeted (see Profiler::GetLastFrameDuration)
+		Reflex::Core::ScopedProfiler profile( GetStageProfileName( stage ) );
+#endif
+
+		if( stage == Reflex::Systems::SystemStage::Physics )
+		{
+			m_contactListener.BeginStep();
+			m_box2DWorld->Step( deltaTime, m_box2DVelocityIterations, m_box2DPositionIterations );
+		}
+
+		UpdateWorldTransforms();
+
+		// Spatial index moves are batched per stage, queries during a stage see the positions from the start of it
+		m_spatialIndex->BeginDeferredMoves();
+
+		// Consecutive systems that don't conflict on their declared component access are grouped and updated concurrently
+		std::vector< Reflex::Systems::BaseSystem* > batch;
+
+		const auto flushBatch = [&]()
+		{
+			if( batch.size() == 1 )
+			{
+				batch.front()->Update( deltaTime );
+			}
+			else if( batch.size() > 1 )
+			{
+				std::vector< JobSystem::Job > jobs;
+				jobs.reserve( batch.size() );
+
+				for( auto* system : batch )
+					jobs.emplace_back( [system, deltaTime]() { system->Update( deltaTime ); } );
+
+				m_jobSystem.RunAndWait( jobs );
+			}
+
+			batch.clear();
+		};
+
+		for( auto* system : m_systemOrder )
+		{
+			if( system->GetStage() != stage )
+				continue;
+
+			const auto conflicts = std::any_of( batch.begin(), batch.end(), [&]( const Reflex::Systems::BaseSystem* other )
+			{
+				return system->ConflictsWith( *other );
+			} );
+
+			if( conflicts )
+				flushBatch();
+
+			batch.push_back( system );
+		}
+
+		flushBatch();
+
+		// Queued events are delivered between stages, never while systems are iterating their objects
+		eventManager.Flush();
+
+		UpdateWorldTransforms();
+		m_spatialIndex->EndDeferredMoves( m_jobSystem );
 	}
 
 	void World::ProcessEvent( const sf::Event& event )
 	{
 		PROFILE;
-		for( auto& system : m_systems )
-			system.second->ProcessEvent( event );
+		for( auto* system : m_systemOrder )
+			system->ProcessEvent( event );
 	}
 
 	void World::Render()
 	{
 		PROFILE;
+		eventManager.Flush();
+		UpdateWorldTransforms();
+
 		const auto camera = GetActiveCamera();
 		GetWindow().setView( camera ? *camera : m_worldView );
 
-		for( auto& system : m_systems )
+		for( auto* system : m_systemOrder )
 		{
-			system.second->RenderUI();
-			GetWindow().draw( *system.second );
+			system->RenderUI();
+			GetWindow().draw( *system );
 		}
 
 		m_box2DWorld->DebugDraw();
@@ -89,29 +196,40 @@ namespace Reflex::Core
 		ImGui::InputInt( "Box2D Position Iterations", &m_box2DPositionIterations );
 		ImGui::InputInt( "Box2D Velocity Iterations", &m_box2DVelocityIterations );
 
+		for( unsigned stage = 0; stage < ( unsigned )Reflex::Systems::SystemStage::NumStages; ++stage )
+		{
+			const auto duration = Profiler::GetProfiler().GetLastFrameDuration( GetStageProfileName( ( Reflex::Systems::SystemStage )stage ) );
+			ImGui::Text( "%s: %.2fms", Reflex::Systems::GetSystemStageName( ( Reflex::Systems::SystemStage )stage ), duration / 1000.0f );
+		}
+
+		if( const auto* renderSystem = GetSystem< Reflex::Systems::RenderSystem >() )
+			ImGui::Text( "Draw calls: %u, Batched vertices: %u", renderSystem->GetLastFrameStats().drawCalls, ( unsigned )renderSystem->GetLastFrameStats().vertices );
+
 		ImGui::End();
 	}
 
-	Object World::CreateObject( const sf::Vector2f& position, const float rotation, const sf::Vector2f& scale, const bool attachToRoot /*= true*/, const bool useTileMap /*= true*/ )
+	unsigned World::AllocateObjectIndex()
 	{
-		unsigned index = 0;
-
 		if( !m_freeList.empty() )
 		{
-			index = m_freeList.back();
+			const auto index = m_freeList.back();
 			m_objects.flags[index].reset();
 			m_freeList.pop();
+			return index;
 		}
-		else
-		{
-			m_objects.components.emplace_back();
-			m_objects.flags.emplace_back();
-			m_objects.counters.emplace_back();
-			index = ( unsigned )m_objects.components.size() - 1;
 
-			for( auto& allocator : m_components )
-				allocator->ExpandToFit( index + 1 );
-		}
+		m_objects.components.emplace_back();
+		m_objects.flags.emplace_back();
+		m_objects.counters.emplace_back();
+		return ( unsigned )m_objects.components.size() - 1;
+	}
+
+	Object World::CreateObject( const sf::Vector2f& position, const float rotation, const sf::Vector2f& scale, const bool attachToRoot /*= true*/, const bool useTileMap /*= true*/ )
+	{
+		const auto index = AllocateObjectIndex();
+
+		for( auto& allocator : m_components )
+			allocator->ExpandToFit( index + 1 );
 
 		Object newObject = ObjectFromIndex( index );
 		const auto transform = newObject.AddComponent< Reflex::Components::Transform >( position, rotation, scale, useTileMap );
@@ -129,8 +247,18 @@ namespace Reflex::Core
 
 	Object World::CreateObject( const std::string& objectFile, const sf::Vector2f& position, const float rotation, const sf::Vector2f& scale, const bool attachToRoot /*= true*/, const bool useTileMap /*= true*/ )
 	{
+		const auto& prefab = GetPrefab( objectFile );
 		auto newObject = CreateObject( position, rotation, scale, attachToRoot, useTileMap );
-		
+		InstantiatePrefab( newObject, prefab );
+		return newObject;
+	}
+
+	const Prefab& World::GetPrefab( const std::string& objectFile )
+	{
+		const auto found = m_prefabs.find( objectFile );
+		if( found != m_prefabs.end() )
+			return found->second;
+
 		const auto dot = objectFile.rfind( '.' );
 
 		if( dot == std::string::npos )
@@ -139,51 +267,279 @@ namespace Reflex::Core
 		const auto fileType = objectFile.substr( dot );
 
 		if( fileType.substr( 0, 3 ) != ".ro" )
-			THROW( "Invalid object file name (must be .ro): " << objectFile );
+			THROW( "Invalid object file name (must be .ro or .rob): " << objectFile );
 
-		//if( fileType.length() > 3 )
-		//	const auto version = std::atoi( &*fileType.rbegin() );
+		// Component names and fields are resolved once here rather than on every instantiation
+		const auto resolver = [this]( const std::string& name, std::size_t& family, FieldTable& fields )
+		{
+			const auto found = m_componentNameToIndex.find( name );
 
-		std::ifstream input( objectFile );
+			if( found == m_componentNameToIndex.end() )
+				return false;
 
-		if( input.fail() )
-			THROW( "Invalid object file name: " << objectFile );
+			family = found->second;
+			fields = m_components[family]->GetFields();
+			return true;
+		};
 
-		Json::CharReaderBuilder reader;
-		Json::Value obj;
-		std::string errs;
+		auto prefab = fileType == ".rob" ? ReadPrefabBinary( objectFile, resolver ) : ReadPrefabJson( objectFile, resolver );
 
-		if( !Json::parseFromStream( reader, input, &obj, &errs ) )
-			THROW( "Invalid object file data: " << objectFile );
+		return m_prefabs.emplace( objectFile, std::move( prefab ) ).first->second;
+	}
 
-		const auto& components = obj["Components"];
+	void World::CompilePrefab( const std::string& objectFile, const std::string& outputFile )
+	{
+		WritePrefabBinary( GetPrefab( objectFile ), outputFile );
+	}
 
-		for( unsigned i = 0; i < components.getMemberNames().size(); ++i )
+	void World::InstantiatePrefab( const Object& object, const Prefab& prefab )
+	{
+		for( const auto& componentData : prefab.components )
 		{
-			const auto componentName = components.getMemberNames()[i];
-			const auto found = m_componentNameToIndex.find( componentName );
+			auto* component = componentData.family == Reflex::Components::Transform::GetFamily()
+				? ObjectGetComponent( object, componentData.family )
+				: ObjectAddEmptyComponent( object, componentData.family );
 
-			if( found == m_componentNameToIndex.end() )
-				THROW( "Invalid component name in file: " << objectFile << " , component: " << componentName );
-
-			Reflex::Components::BaseComponent* component = nullptr;
-				
-			if( componentName == Reflex::Components::Transform::GetComponentName() )
-				component = ObjectGetComponent( newObject, found->second );
-			else
-				component = ObjectAddEmptyComponent( newObject, found->second );
-				
-			const auto& componentData = components[componentName];
-			for( unsigned j = 0; j < componentData.getMemberNames().size(); ++j )
+			for( const auto& value : componentData.values )
+				value.field->set( *component, value.value );
+		}
+	}
+
+	void World::SaveSnapshot( const std::string& file )
+	{
+		PROFILE;
+		BinaryWriter writer( file );
+
+		writer.WriteUInt( SnapshotMagic );
+		writer.WriteUInt( SnapshotVersion );
+
+		// Object data
+		const auto objectCount = ( std::uint32_t )m_objects.counters.size();
+		writer.WriteUInt( objectCount );
+
+		std::vector< std::uint32_t > bits( objectCount );
+		for( std::uint32_t i = 0; i < objectCount; ++i )
+			bits[i] = ( std::uint32_t )m_objects.flags[i].to_ulong();
+		writer.WriteArray( bits.data(), bits.size() );
+
+		for( std::uint32_t i = 0; i < objectCount; ++i )
+			bits[i] = ( std::uint32_t )m_objects.components[i].to_ulong();
+		writer.WriteArray( bits.data(), bits.size() );
+
+		static_assert( sizeof( unsigned ) == sizeof( std::uint32_t ) );
+		writer.WriteArray( m_objects.counters.data(), m_objects.counters.size() );
+
+		writer.WriteUInt( IsValidObject( m_sceneGraphRoot ) ? m_sceneGraphRoot.GetIndex() : InvalidSnapshotIndex );
+		writer.WriteUInt( IsValidObject( m_activeCamera ) ? m_activeCamera.GetIndex() : InvalidSnapshotIndex );
+
+		// Only the TileMap's settings are saved, its contents are rebuilt as the transforms are loaded
+		const auto* tileMap = dynamic_cast< const TileMap* >( m_spatialIndex.get() );
+		writer.WriteValue( ( std::uint8_t )( tileMap != nullptr ) );
+
+		if( tileMap )
+		{
+			writer.WriteUInt( tileMap->GetCellSize() );
+			writer.WriteUInt( tileMap->GetChunkSizeInCells() );
+		}
+
+		// Scene graph in pre-order, so parents are loaded before their children and children keep their order
+		std::vector< SnapshotNode > nodes;
+		nodes.reserve( objectCount );
+
+		m_transformHierarchy.ForEachNode( [&]( const BaseObject& object, const BaseObject& parent )
+		{
+			nodes.push_back( { object.GetIndex(), parent.GetIndex(), ObjectGetComponent< Reflex::Components::Transform >( object )->UsesTileMap() } );
+		} );
+
+		writer.WriteUInt( ( std::uint32_t )nodes.size() );
+		writer.WriteArray( nodes.data(), nodes.size() );
+
+		// Component families and their fields, then the values of every component family by family (in object order)
+		writer.WriteUInt( ( std::uint32_t )m_components.size() );
+
+		for( std::size_t family = 0; family < m_components.size(); ++family )
+		{
+			const auto componentName = std::find_if( m_componentNameToIndex.begin(), m_componentNameToIndex.end(), [&]( const auto& pair )
+			{
+				return pair.second == family;
+			} );
+
+			// Components that were never registered can't be found by name when loading
+			writer.WriteString( componentName != m_componentNameToIndex.end() ? componentName->first : std::string() );
+
+			const auto fields = m_components[family]->GetFields();
+			writer.WriteUInt( ( std::uint32_t )fields.size() );
+
+			for( const auto& field : fields )
 			{
-				const auto variable = componentData.getMemberNames()[j];
-				const auto value = componentData[variable].asString();
-				if( !component->SetValue( variable, value ) )
-					THROW( "Invalid component variable name in file: " << objectFile << " , component: " << componentName << ", variable: " << variable );
+				writer.WriteString( field.name );
+				writer.WriteValue( ( std::uint8_t )field.type );
 			}
 		}
 
-		return newObject;
+		for( std::size_t family = 0; family < m_components.size(); ++family )
+		{
+			const auto fields = m_components[family]->GetFields();
+
+			for( std::uint32_t i = 0; i < objectCount; ++i )
+			{
+				if( !m_objects.components[i].test( family ) )
+					continue;
+
+				const auto* component = ObjectGetComponent( ObjectFromIndex( i ), family );
+
+				for( const auto& field : fields )
+					writer.WriteFieldValue( field.get( *component ) );
+			}
+		}
+	}
+
+	void World::LoadSnapshot( const std::string& file )
+	{
+		PROFILE;
+		const MappedFile mappedFile( file );
+		BinaryReader reader( mappedFile, file );
+
+		if( reader.ReadUInt() != SnapshotMagic )
+			THROW( "Invalid snapshot file: " << file );
+
+		const auto version = reader.ReadUInt();
+		if( version != SnapshotVersion )
+			THROW( "Unsupported snapshot file version: " << file << ", version: " << version );
+
+		// The whole file is read and checked before the world is cleared
+		const auto objectCount = reader.ReadUInt();
+		const auto flags = reader.ReadVector< std::uint32_t >( objectCount );
+		const auto masks = reader.ReadVector< std::uint32_t >( objectCount );
+		auto counters = reader.ReadVector< unsigned >( objectCount );
+
+		const auto rootIndex = reader.ReadUInt();
+		const auto cameraIndex = reader.ReadUInt();
+
+		const auto hasTileMap = reader.ReadValue< std::uint8_t >() != 0;
+		const auto cellSize = hasTileMap ? reader.ReadUInt() : 0U;
+		const auto chunkSizeInCells = hasTileMap ? reader.ReadUInt() : 0U;
+
+		const auto nodeCount = reader.ReadUInt();
+		const auto nodes = reader.ReadVector< SnapshotNode >( nodeCount );
+
+		const auto familyCount = reader.ReadUInt();
+		if( familyCount > MaxComponents )
+			THROW( "Invalid snapshot file data: " << file );
+
+		std::vector< SnapshotFamily > families( familyCount );
+
+		for( auto& family : families )
+		{
+			const auto name = reader.ReadString();
+			const auto found = m_componentNameToIndex.find( name );
+			const auto fields = found != m_componentNameToIndex.end() ? m_components[found->second]->GetFields() : FieldTable();
+
+			if( found != m_componentNameToIndex.end() )
+				family.family = found->second;
+
+			const auto fieldCount = reader.ReadUInt();
+
+			for( std::uint32_t i = 0; i < fieldCount; ++i )
+			{
+				const auto fieldName = reader.ReadString();
+				const auto type = ( FieldType )reader.ReadValue< std::uint8_t >();
+				const auto* field = fields.Find( fieldName );
+
+				if( type >= FieldType::NumTypes || ( field && field->type != type ) )
+					THROW( "Mismatched variable type in snapshot file: " << file << " , component: " << name << ", variable: " << fieldName );
+
+				family.types.push_back( type );
+				family.fields.push_back( field );
+			}
+		}
+
+		for( std::uint32_t i = 0; i < objectCount; ++i )
+			for( std::uint32_t family = 0; family < familyCount; ++family )
+				if( ( masks[i] & ( 1U << family ) ) && !families[family].family )
+					THROW( "Unknown component in snapshot file: " << file << ", the component must be registered before loading" );
+
+		for( const auto& node : nodes )
+			if( node.object >= objectCount || ( flags[node.object] & ( 1U << ( size_t )ObjectFlags::Deleted ) ) || ( node.parent != InvalidSnapshotIndex && node.parent >= objectCount ) )
+				THROW( "Invalid snapshot file data: " << file );
+
+		// Component values are decoded up front too, so a truncated or corrupt file throws before the world is touched
+		std::vector< FieldValue > values;
+
+		for( std::uint32_t family = 0; family < familyCount; ++family )
+			for( std::uint32_t i = 0; i < objectCount; ++i )
+				if( masks[i] & ( 1U << family ) )
+					for( const auto type : families[family].types )
+						values.push_back( reader.ReadFieldValue( type ) );
+
+		// Replace the world's objects, indices and counters are restored exactly
+		DestroyAllObjects();
+
+		m_objects.flags.assign( objectCount, {} );
+		m_objects.components.assign( objectCount, {} );
+		m_objects.counters = std::move( counters );
+		m_freeList = {};
+
+		for( auto& allocator : m_components )
+			allocator->ExpandToFit( objectCount );
+
+		if( auto* tileMap = dynamic_cast< TileMap* >( m_spatialIndex.get() ); tileMap && hasTileMap )
+			tileMap->Reset( cellSize, chunkSizeInCells );
+
+		std::vector< Object > objects;
+		objects.reserve( objectCount );
+
+		for( std::uint32_t i = 0; i < objectCount; ++i )
+		{
+			m_objects.flags[i] = flags[i];
+			m_objects.flags[i].reset( ( size_t )ObjectFlags::DeferSystemMembership );
+
+			if( IsObjectFlagSet( i, ObjectFlags::Deleted ) )
+				continue;
+
+			// Systems are updated once all of the objects are loaded
+			SetObjectFlag( i, ObjectFlags::DeferSystemMembership );
+			objects.push_back( ObjectFromIndex( i ) );
+		}
+
+		for( const auto& node : nodes )
+		{
+			const auto object = ObjectFromIndex( node.object );
+			ObjectAddComponent< Reflex::Components::Transform >( object, sf::Vector2f(), 0.0f, sf::Vector2f( 1.0f, 1.0f ), node.useTileMap != 0 );
+
+			if( node.parent != InvalidSnapshotIndex )
+				ObjectGetComponent< Reflex::Components::Transform >( ObjectFromIndex( node.parent ) )->AttachChild( object );
+		}
+
+		auto value = values.begin();
+
+		for( std::uint32_t family = 0; family < familyCount; ++family )
+		{
+			const auto& snapshotFamily = families[family];
+
+			for( std::uint32_t i = 0; i < objectCount; ++i )
+			{
+				if( !( masks[i] & ( 1U << family ) ) )
+					continue;
+
+				const auto object = ObjectFromIndex( i );
+				auto* component = ObjectHasComponent( object, *snapshotFamily.family )
+					? ObjectGetComponent( object, *snapshotFamily.family )
+					: ObjectAddEmptyComponent( object, *snapshotFamily.family );
+
+				for( const auto* field : snapshotFamily.fields )
+				{
+					if( field )
+						field->set( *component, *value );
+					++value;
+				}
+			}
+		}
+
+		m_sceneGraphRoot = rootIndex < objectCount ? ObjectFromIndex( rootIndex ) : BaseObject();
+		m_activeCamera = cameraIndex < objectCount ? ObjectFromIndex( cameraIndex ) : BaseObject();
+
+		EndCreateObjects( objects );
 	}
 
 	void World::CreateROFile( const std::string& name, const Object& object )
@@ -194,7 +550,7 @@ namespace Reflex::Core
 
 		if( dot == std::string::npos )
 			path = path.append( ".ro" );
-		else if( path.substr( 0, 3 ) != ".ro" )
+		else if( path.substr( dot ) != ".ro" )
 			THROW( "Invalid object file name (must be .ro): " << name );
 
 		Json::Value jsonOut;
@@ -207,12 +563,12 @@ namespace Reflex::Core
 			if( !flags.test( i ) )
 				continue;
 
-			Json::Value data;
-			std::vector< std::pair< std::string, std::string > > values;
-			ObjectGetComponent( object, i )->GetValues( values );
+			Json::Value data( Json::objectValue );
+			const auto* component = ObjectGetComponent( object, i );
 
-			for( const auto& [key, value] : values )
-				data[key] = value;
+			for( const auto& field : m_components[i]->GetFields() )
+				if( field.ShouldSave( *component ) )
+					data[field.name] = FieldValueToJson( field.get( *component ) );
 
 			const auto componentName = std::find_if( m_componentNameToIndex.begin(), m_componentNameToIndex.end(), [&]( const auto& pair )
 			{
@@ -287,11 +643,103 @@ namespace Reflex::Core
 		m_objects.counters[object.GetIndex()]++;
 	}
 
+	std::vector< Object > World::BeginCreateObjects( const std::size_t count, const bool attachToRoot, const bool useTileMap )
+	{
+		PROFILE;
+		std::vector< Object > objects;
+		objects.reserve( count );
+
+		// Component storage is expanded once for the whole batch
+		unsigned maxIndex = 0;
+		for( std::size_t i = 0; i < count; ++i )
+		{
+			objects.push_back( ObjectFromIndex( AllocateObjectIndex() ) );
+			maxIndex = std::max( maxIndex, objects.back().GetIndex() );
+		}
+
+		if( count > 0 )
+			for( auto& allocator : m_components )
+				allocator->ExpandToFit( maxIndex + 1 );
+
+		// Flagged per object rather than for the whole world, so objects created by the initialise callback still join systems as usual
+		for( auto& newObject : objects )
+		{
+			SetObjectFlag( newObject, ObjectFlags::DeferSystemMembership );
+			newObject.AddComponent< Reflex::Components::Transform >( sf::Vector2f(), 0.0f, sf::Vector2f( 1.0f, 1.0f ), useTileMap );
+
+			if( attachToRoot )
+			{
+				assert( GetSceneRoot().IsValid() );
+				GetSceneRoot()->AttachChild( newObject );
+			}
+
+			SetObjectFlag( newObject, ObjectFlags::ConstructionComplete );
+		}
+
+		return objects;
+	}
+
+	void World::EndCreateObjects( const std::vector< Object >& objects )
+	{
+		PROFILE;
+
+		for( const auto& object : objects )
+			if( IsValidObject( object ) )
+				m_objects.flags[object.GetIndex()].reset( ( size_t )ObjectFlags::DeferSystemMembership );
+
+		for( const auto& [type, baseSystem] : m_systems )
+		{
+			auto* system = static_cast< Reflex::Systems::System* >( baseSystem.get() );
+
+			for( const auto& object : objects )
+			{
+				if( !IsValidObject( object ) || system->HasObject( object ) || !system->ShouldAddObject( object ) )
+					continue;
+
+				system->InsertObject( object );
+				system->AddComponent( object );
+				system->OnComponentAdded( object );
+			}
+		}
+	}
+
+	void World::DestroyObjects( const std::vector< Object >& objects )
+	{
+		PROFILE;
+
+		for( const auto& [type, baseSystem] : m_systems )
+		{
+			auto* system = static_cast< Reflex::Systems::System* >( baseSystem.get() );
+
+			for( const auto& object : objects )
+			{
+				if( !IsValidObject( object ) || !system->HasObject( object ) )
+					continue;
+
+				system->EraseObject( object );
+				system->OnComponentRemoved( object );
+			}
+		}
+
+		for( const auto& object : objects )
+		{
+			if( !IsValidObject( object ) )
+				continue;
+
+			SetObjectFlag( object, ObjectFlags::DeferSystemMembership );
+			DestroyObject( object );
+		}
+	}
+
 	void World::DestroyAllObjects()
 	{
+		std::vector< Object > objects;
+
 		for( unsigned i = 0; i < m_objects.counters.size(); ++i )
 			if( !IsObjectFlagSet( i, ObjectFlags::Deleted ) )
-				DestroyObject( ObjectFromIndex( i ) );
+				objects.push_back( ObjectFromIndex( i ) );
+
+		DestroyObjects( objects );
 	}
 
 	bool World::IsValidObject( const BaseObject& object ) const
@@ -336,6 +784,12 @@ namespace Reflex::Core
 				ObjectRemoveComponent( object, i );
 	}
 
+	void World::UpdateWorldTransforms()
+	{
+		PROFILE;
+		m_transformHierarchy.UpdateWorldTransforms();
+	}
+
 	sf::FloatRect World::GetBounds() const
 	{
 		return m_worldBounds;
@@ -348,20 +802,20 @@ namespace Reflex::Core
 
 	void World::OnComponentAdded( const BaseObject& base )
 	{
+		if( IsObjectFlagSet( base, ObjectFlags::DeferSystemMembership ) )
+			return;
+
 		const auto object = Object( base );
 		assert( IsValidObject( object ) );
 
-		// Here we want to check if we should add this component to any systems
+		// Here we want to check if we should add this component to any systems, the membership check is constant time so is done first
 		for( const auto&[type, baseSystem] : m_systems )
 		{
-			if( !baseSystem->ShouldAddObject( object ) )
-				continue;
-
 			auto* system = static_cast< Reflex::Systems::System* >( baseSystem.get() );
-			const auto found = Reflex::Find( system->m_releventObjects, object );
-			if( found != system->m_releventObjects.end() )
+			if( system->HasObject( object ) || !system->ShouldAddObject( object ) )
 				continue;
 
+			system->InsertObject( object );
 			system->AddComponent( object ); 
 			system->OnComponentAdded( object );
 		}
@@ -369,21 +823,19 @@ namespace Reflex::Core
 
 	void World::OnComponentRemoved( const BaseObject& base )
 	{
+		if( IsObjectFlagSet( base, ObjectFlags::DeferSystemMembership ) )
+			return;
+
 		const auto object = Object( base );
 
 		for( const auto& [type, baseSystem] : m_systems )
 		{
-			if( !baseSystem->ShouldAddObject( object ) )
-				continue;
-
 			auto* system = static_cast< Reflex::Systems::System* >( baseSystem.get() );
-			const auto found = Reflex::Find( system->m_releventObjects, object );
-			if( found == system->m_releventObjects.end() )
+			if( !system->HasObject( object ) || !system->ShouldAddObject( object ) )
 				continue;
 
-			const auto toRemove = *found;
-			system->m_releventObjects.erase( found );
-			system->OnComponentRemoved( toRemove );
+			system->EraseObject( object );
+			system->OnComponentRemoved( object );
 		}
 	}
 
@@ -445,29 +897,76 @@ namespace Reflex::Core
 		return output;
 	}
 
-	World::RayCastResult World::RayCast( const sf::Vector2f& from, const sf::Vector2f& to )
+	namespace
 	{
-		class RayCastCallback : public b2RayCastCallback {
+		// The value returned from ReportFixture tells Box2D how to continue: -1 ignores the fixture, 0 ends the query,
+		// the hit's fraction clips the ray to it (so only closer fixtures are still tested) and 1 carries on unclipped
+		class RayCastCallback : public b2RayCastCallback
+		{
 		public:
-			std::vector< RayCastResult > foundBodies;
+			RayCastCallback( const World::RayCastMode mode, std::vector< World::RayCastResult >* allHits = nullptr )
+				: m_mode( mode )
+				, m_allHits( allHits )
+			{
+			}
 
 			float ReportFixture( b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float fraction ) final
 			{
-				const auto object = *(Object* )fixture->GetBody()->GetUserData();
-				foundBodies.push_back( RayCastResult( object, fixture, Reflex::B2VecToVector2f( point ), Reflex::B2VecToVector2f( normal ), fraction ) );
-				return true;
+				const auto* object = static_cast< const Object* >( fixture->GetBody()->GetUserData() );
+				if( !object )
+					return -1.0f;
+
+				// Normals are directions, so aren't scaled to world units
+				World::RayCastResult hit( *object, fixture, Reflex::B2VecToVector2f( point ), sf::Vector2f( normal.x, normal.y ), fraction );
+
+				if( m_allHits )
+				{
+					m_allHits->push_back( hit );
+					return 1.0f;
+				}
+
+				result = hit;
+				return m_mode == World::RayCastMode::Any ? 0.0f : fraction;
 			}
+
+			World::RayCastResult result;
+
+		private:
+			World::RayCastMode m_mode = World::RayCastMode::Closest;
+			std::vector< World::RayCastResult >* m_allHits = nullptr;
 		};
+	}
+
+	World::RayCastResult World::RayCast( const sf::Vector2f& from, const sf::Vector2f& to, const RayCastMode mode ) const
+	{
+		// Box2D asserts on zero length rays
+		if( from == to )
+			return RayCastResult();
 
-		RayCastCallback callback;
+		RayCastCallback callback( mode );
 		GetBox2DWorld().RayCast( &callback, Reflex::Vector2fToB2Vec( from ), Reflex::Vector2fToB2Vec( to ) );
+		return callback.result;
+	}
+
+	void World::RayCastAll( const sf::Vector2f& from, const sf::Vector2f& to, std::vector< RayCastResult >& out ) const
+	{
+		if( from == to )
+			return;
 
-		const auto min = std::min_element( callback.foundBodies.begin(), callback.foundBodies.end(), [&from]( const auto& a, const auto& b )
+		RayCastCallback callback( RayCastMode::Closest, &out );
+		GetBox2DWorld().RayCast( &callback, Reflex::Vector2fToB2Vec( from ), Reflex::Vector2fToB2Vec( to ) );
+	}
+
+	void World::RayCastBatch( const std::vector< Ray >& rays, std::vector< RayCastResult >& out, const RayCastMode mode ) const
+	{
+		PROFILE;
+		out.resize( rays.size() );
+
+		m_jobSystem.ParallelFor( rays.size(), 64, [&]( const std::size_t begin, const std::size_t end )
 		{
-			return Reflex::GetDistanceSq( a.GetObject().GetTransform()->getPosition(), from ) < Reflex::GetDistanceSq( b.GetObject().GetTransform()->getPosition(), from );
+			for( auto i = begin; i < end; ++i )
+				out[i] = RayCast( rays[i].from, rays[i].to, mode );
 		} );
-
-		return min == callback.foundBodies.end() ? RayCastResult() : *min;
 	}
 
 	World::RayCastResult::RayCastResult( Object object, b2Fixture* fixture, const sf::Vector2f& point, const sf::Vector2f& normal, const float fraction )
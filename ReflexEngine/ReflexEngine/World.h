@@ -7,9 +7,14 @@
 #include "ComponentAllocator.h"
 #include "EventManager.h"
 #include "TileMap.h"
+#include "LooseQuadTree.h"
 #include "BaseObject.h"
 #include "Component.h"
 #include "Box2DDebugDraw.h"
+#include "ContactListener.h"
+#include "JobSystem.h"
+#include "TransformHierarchy.h"
+#include "Prefab.h"
 
 // Engine class
 namespace Reflex 
@@ -25,11 +30,18 @@ namespace Reflex
 
 namespace Reflex::Core
 {
+	template< class... Components >
+	class View;
+
 	// World class
 	class World : private sf::NonCopyable
 	{
 	public:
-		explicit World( const Context& context, const sf::FloatRect& worldBounds, const sf::Vector2f& gravity = sf::Vector2f( 0.0f, 9.8f ) );
+		template< class... Components >
+		friend class View;
+
+		// workerThreads is passed to the job system (-1 uses the hardware thread count, 0 runs everything on the calling thread)
+		explicit World( const Context& context, const sf::FloatRect& worldBounds, const sf::Vector2f& gravity = sf::Vector2f( 0.0f, 9.8f ), const int workerThreads = -1 );
 		~World();
 
 		void Update( const float deltaTime );
@@ -41,7 +53,26 @@ namespace Reflex::Core
 		Object CreateObject( const sf::Vector2f& position = {}, const float rotation = 0.0f, const sf::Vector2f& scale = sf::Vector2f( 1.0f, 1.0f ), const bool attachToRoot = true, const bool useTileMap = true );
 		Object CreateObject( const std::string& objectFile, const sf::Vector2f& position = {}, const float rotation = 0.0f, const sf::Vector2f& scale = sf::Vector2f( 1.0f, 1.0f ), const bool attachToRoot = true, const bool useTileMap = true );
 
+		// Creates count objects (each with a Transform, at the origin), initialise( object, i ) is then called on each to add its components
+		// Object storage is grown once for the whole batch and systems only check each object once, after initialise has added everything
+		template< typename Func >
+		std::vector< Object > CreateObjects( const std::size_t count, Func initialise, const bool attachToRoot = true, const bool useTileMap = true );
+
+		// Object files are parsed once and cached, .rob files are the compiled binary form of .ro files (see CompilePrefab)
+		const Prefab& GetPrefab( const std::string& objectFile );
+		void CompilePrefab( const std::string& objectFile, const std::string& outputFile );
+		void ClearPrefabCache() { m_prefabs.clear(); }
+		void InstantiatePrefab( const Object& object, const Prefab& prefab );
+
+		// Saves every object (flags, counters, component masks and each component's fields), the scene graph and the TileMap settings
+		// Loading replaces every object in the world, objects keep their index and counter so handles stored with the snapshot stay valid
+		// Snapshots are read through a memory mapping of the file, systems pick up the loaded objects in one batch (as with CreateObjects)
+		void SaveSnapshot( const std::string& file );
+		void LoadSnapshot( const std::string& file );
+
 		void DestroyObject( const BaseObject& object );
+		// Every system drops the batch in one pass before the components are destroyed
+		void DestroyObjects( const std::vector< Object >& objects );
 		void DestroyAllObjects();
 
 		bool IsValidObject( const BaseObject& object ) const;
@@ -77,14 +108,29 @@ namespace Reflex::Core
 		bool ObjectHasComponent( const BaseObject& object, const size_t family ) const;
 
 		// Returns true if the register resulted in a new component being allocated
+		// The storage policy is only applied when the allocator is first created (Packed suits components used by few objects)
 		template< class T >
-		bool RegisterComponent();
+		bool RegisterComponent( const ComponentStorage storage = ComponentStorage::Indexed );
+
+		// Calls function( T& ) for every live component of the template type (packed components are walked contiguously)
+		template< class T, typename Func >
+		void ForEachComponent( Func function );
+
+		// Returns a view over all objects that have every one of the template component types (see View.h)
+		template< class... Components >
+		View< Components... > GetView();
 		/*---------------*/
 
 		/* System functions*/
+		// Adds the system to the end of the PrePhysics stage (after the built-in steering and movement systems)
 		template< class T, typename... Args >
 		T* AddSystem( Args&& ... args );
 
+		// Adds the system to a stage of the update pipeline, systems within a stage update in ascending order (ties keep the order they were added)
+		// Events and rendering also follow the pipeline order
+		template< class T, typename... Args >
+		T* AddSystemToStage( const Reflex::Systems::SystemStage stage, const int order, Args&& ... args );
+
 		template< class T >
 		T* GetSystem();
 
@@ -100,17 +146,31 @@ namespace Reflex::Core
 		TextureManager& GetTextureManager() { return m_context.textureManager; }
 		FontManager& GetFontManager() { return m_context.fontManager; }
 		EventManager& GetEventManager() { return eventManager; }
-		TileMap& GetTileMap() { return m_tileMap; }
-		const TileMap& GetTileMap() const { return m_tileMap; }
+		SpatialIndex& GetSpatialIndex() { return *m_spatialIndex; }
+		const SpatialIndex& GetSpatialIndex() const { return *m_spatialIndex; }
+
+		// Replaces the spatial index (a TileMap by default), existing objects are moved into the new index
+		template< class T, typename... Args >
+		T* SetSpatialIndex( Args&& ... args );
+		JobSystem& GetJobSystem() const { return m_jobSystem; }
+		TransformHierarchy& GetTransformHierarchy() { return m_transformHierarchy; }
+		const TransformHierarchy& GetTransformHierarchy() const { return m_transformHierarchy; }
 		b2World& GetBox2DWorld() { return *m_box2DWorld; }
 		const b2World& GetBox2DWorld() const { return *m_box2DWorld; }
 
+		// Contacts reported during the last Box2D step, systems in the Physics stage update after the step so they see the current one
+		const std::vector< Contact >& GetContacts() const { return m_contactListener.GetContacts(); }
+
 		sf::FloatRect GetBounds() const;
 		Reflex::Handle< Reflex::Components::Transform > GetSceneRoot() const;
 
 		void OnComponentAdded( const BaseObject& object );
 		void OnComponentRemoved( const BaseObject& object );
 
+		// Dirty world transforms are refreshed in one sweep of the transform hierarchy at the start and end of each stage and before rendering
+		// Systems updating concurrently then only read cached world transforms, unless the stage itself moves objects
+		void UpdateWorldTransforms();
+
 		bool IsActiveCamera( const Reflex::Handle< Reflex::Components::Camera >& camera ) const;
 		void SetActiveCamera( const Reflex::Handle< Reflex::Components::Camera >& camera );
 		Reflex::Handle< Reflex::Components::Camera > GetActiveCamera() const;
@@ -133,8 +193,9 @@ namespace Reflex::Core
 			RayCastResult( Object object, b2Fixture* fixture, const sf::Vector2f& point, const sf::Vector2f& normal, const float fraction );
 			bool hit = false;
 			b2Fixture* fixture = nullptr;
-			const sf::Vector2f point;
-			const sf::Vector2f normal;
+			sf::Vector2f point;
+			sf::Vector2f normal;
+			// Distance along the ray to the hit, 0 at from and 1 at to
 			float fraction = 0.0f;
 			operator bool() const;
 			Object GetObject() const;
@@ -143,11 +204,38 @@ namespace Reflex::Core
 			BaseObject object;
 		};
 
-		RayCastResult RayCast( const sf::Vector2f& from, const sf::Vector2f& to );
+		enum class RayCastMode
+		{
+			// The hit nearest to from, Box2D clips the ray to each closer hit so fewer fixtures are tested
+			Closest,
+			// Any hit, the query stops at the first fixture found (eg. line of sight checks)
+			Any,
+		};
+
+		struct Ray
+		{
+			sf::Vector2f from;
+			sf::Vector2f to;
+		};
+
+		// Only fixtures of bodies owned by an object (a RigidBody) are reported
+		RayCastResult RayCast( const sf::Vector2f& from, const sf::Vector2f& to, const RayCastMode mode = RayCastMode::Closest ) const;
+		RayCastResult RayCastAny( const sf::Vector2f& from, const sf::Vector2f& to ) const { return RayCast( from, to, RayCastMode::Any ); }
+
+		// Appends every hit along the ray to out, in the order Box2D finds them (not sorted by fraction)
+		void RayCastAll( const sf::Vector2f& from, const sf::Vector2f& to, std::vector< RayCastResult >& out ) const;
+
+		// Casts each ray, out[i] is the result of rays[i]. Queries only read the Box2D broadphase so rays are split across the job system
+		// Must not be called while the Box2D world is stepping
+		void RayCastBatch( const std::vector< Ray >& rays, std::vector< RayCastResult >& out, const RayCastMode mode = RayCastMode::Closest ) const;
 
 	protected:
 		void Setup();
 		Object ObjectFromIndex( const unsigned index );
+		unsigned AllocateObjectIndex();
+		std::vector< Object > BeginCreateObjects( const std::size_t count, const bool attachToRoot, const bool useTileMap );
+		void EndCreateObjects( const std::vector< Object >& objects );
+		void UpdateStage( const Reflex::Systems::SystemStage stage, const float deltaTime );
 
 		bool IsObjectFlagSet( const std::uint32_t objectIndex, const ObjectFlags flag ) const;
 		void SetObjectFlag( const std::uint32_t objectIndex, const ObjectFlags flag );
@@ -162,6 +250,11 @@ namespace Reflex::Core
 
 		float m_deltaTime = 0.0f;
 
+		// Worker threads used to update non-conflicting systems concurrently and for systems to split their own work (mutable as it holds no world state)
+		mutable JobSystem m_jobSystem;
+
+		ContactListener m_contactListener;
+
 		// Box2d world, allocated on the heap because the b2World class is huge (103kb)
 		std::unique_ptr< b2World > m_box2DWorld;
 		float m_box2DUnitToPixelScale = 32;
@@ -173,8 +266,11 @@ namespace Reflex::Core
 		// Handler for event system
 		EventManager eventManager;
 
-		// Tilemap which stores object handles in the world in an efficient spacial hash map
-		TileMap m_tileMap;
+		// Spatial index which stores object handles by location for range queries (TileMap or LooseQuadTree)
+		std::unique_ptr< SpatialIndex > m_spatialIndex;
+
+		// Scene graph of every transform, sorted parents before children
+		TransformHierarchy m_transformHierarchy;
 
 		// Object data
 		struct ObjectData
@@ -190,11 +286,15 @@ namespace Reflex::Core
 		// Storage for all components
 		std::vector< std::unique_ptr< ComponentAllocatorBase > > m_components;
 		std::unordered_map< std::string, size_t > m_componentNameToIndex;
+		std::unordered_map< std::string, Prefab > m_prefabs;
 		std::queue< unsigned > m_freeList;
 
 		// List of systems, indexed by their type, storage for all systems
 		std::unordered_map< Type, std::unique_ptr< Reflex::Systems::BaseSystem > > m_systems;
 
+		// Systems sorted by stage then order, this is the order they are updated / processed / rendered in
+		std::vector< Reflex::Systems::BaseSystem* > m_systemOrder;
+
 		BaseObject m_sceneGraphRoot;
 		BaseObject m_activeCamera;
 	};
@@ -258,7 +358,7 @@ namespace Reflex::Core
 	}
 
 	template< class T >
-	bool World::RegisterComponent()
+	bool World::RegisterComponent( const ComponentStorage storage )
 	{
 		const auto family = T::GetFamily();
 
@@ -266,14 +366,44 @@ namespace Reflex::Core
 		{
 			assert( family == m_components.size() );
 			m_componentNameToIndex[T::GetComponentName()] = m_components.size();
-			m_components.push_back( std::unique_ptr< ComponentAllocatorBase >( new ComponentAllocator< T >( 128 ) ) );
+			m_components.push_back( std::unique_ptr< ComponentAllocatorBase >( new ComponentAllocator< T >( 128, storage ) ) );
 			return true;
 		}
 		return false;
 	}
 
+	template< class T, typename Func >
+	void World::ForEachComponent( Func function )
+	{
+		const auto family = T::GetFamily();
+
+		if( family >= m_components.size() )
+			return;
+
+		auto* allocator = static_cast< ComponentAllocator< T >* >( m_components[family].get() );
+
+		if( allocator->IsPacked() )
+		{
+			allocator->ForEachPacked( [&]( const std::uint32_t, T& component )
+			{
+				function( component );
+			} );
+			return;
+		}
+
+		for( unsigned i = 0; i < m_objects.components.size(); ++i )
+			if( m_objects.components[i].test( family ) )
+				function( *allocator->Get( i ) );
+	}
+
 	template< class T, typename... Args >
 	T* World::AddSystem( Args&& ... args )
+	{
+		return AddSystemToStage< T >( Reflex::Systems::SystemStage::PrePhysics, std::numeric_limits< int >::max(), std::forward< Args >( args )... );
+	}
+
+	template< class T, typename... Args >
+	T* World::AddSystemToStage( const Reflex::Systems::SystemStage stage, const int order, Args&& ... args )
 	{
 		const auto type = Type( typeid( T ) );
 
@@ -284,6 +414,8 @@ namespace Reflex::Core
 		}
 
 		auto system = std::make_unique< T >( *this, std::forward< Args >( args )... );
+		system->m_stage = stage;
+		system->m_order = order;
 
 		// Register components
 		system->RegisterComponents();
@@ -297,6 +429,7 @@ namespace Reflex::Core
 			if( !system->ShouldAddObject( ObjectFromIndex( i ) ) )
 				continue;
 
+			system->InsertObject( ObjectFromIndex( i ) );
 			system->AddComponent( ObjectFromIndex( i ) );
 			system->OnComponentAdded( ObjectFromIndex( i ) );
 		}
@@ -304,11 +437,42 @@ namespace Reflex::Core
 		auto result = m_systems.insert( std::make_pair( type, std::move( system ) ) );
 		assert( result.second );
 
+		const auto insertPos = std::upper_bound( m_systemOrder.begin(), m_systemOrder.end(), result.first->second.get(), []( const Reflex::Systems::BaseSystem* a, const Reflex::Systems::BaseSystem* b )
+		{
+			return std::make_pair( a->GetStage(), a->GetOrder() ) < std::make_pair( b->GetStage(), b->GetOrder() );
+		} );
+		m_systemOrder.insert( insertPos, result.first->second.get() );
+
 		result.first->second->OnSystemStartup();
 
 		return ( T* )result.first->second.get();
 	}
 
+	template< typename Func >
+	std::vector< Object > World::CreateObjects( const std::size_t count, Func initialise, const bool attachToRoot, const bool useTileMap )
+	{
+		auto objects = BeginCreateObjects( count, attachToRoot, useTileMap );
+
+		for( std::size_t i = 0; i < objects.size(); ++i )
+			initialise( objects[i], i );
+
+		EndCreateObjects( objects );
+		return objects;
+	}
+
+	template< class T, typename... Args >
+	T* World::SetSpatialIndex( Args&& ... args )
+	{
+		if( m_spatialIndex )
+			m_spatialIndex->Reset();
+
+		auto spatialIndex = std::make_unique< T >( std::forward< Args >( args )... );
+		auto* result = spatialIndex.get();
+		m_spatialIndex = std::move( spatialIndex );
+		m_spatialIndex->Repopulate( *this );
+		return result;
+	}
+
 	template< class T >
 	void World::RemoveSystem()
 	{
@@ -319,6 +483,7 @@ namespace Reflex::Core
 			if( systemType == iter->first )
 			{
 				iter->second->OnSystemShutdown();
+				m_systemOrder.erase( std::find( m_systemOrder.begin(), m_systemOrder.end(), iter->second.get() ) );
 				iter->second.reset();
 				m_systems.erase( iter );
 				break;
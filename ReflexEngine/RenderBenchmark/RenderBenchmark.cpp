@@ -0,0 +1,167 @@
+#include "../ReflexEngine/Include.h"
+
+using namespace Reflex;
+
+// Headless benchmark of RenderSystem::Render, draws every scenario into an offscreen render texture and reports
+// the draw calls, vertices and CPU time per frame. Usage: RenderBenchmark [objectCount] [frameCount] [fontFile]
+namespace
+{
+	struct BenchmarkParams
+	{
+		unsigned objectCount = 10000U;
+		unsigned frameCount = 100U;
+		unsigned warmupFrames = 5U;
+		std::string fontFile;
+	};
+
+	BenchmarkParams s_params;
+
+	const sf::Vector2u TargetSize( 1920U, 1080U );
+}
+
+class BenchmarkState : public Core::State
+{
+public:
+	BenchmarkState( Core::StateManager& stateManager )
+		: State( stateManager )
+	{
+		// Generated textures so the benchmark doesn't depend on any assets, two are used to measure texture switches breaking batches
+		sf::Image image;
+		image.create( 16U, 16U, sf::Color::White );
+		m_textures[0].loadFromImage( image );
+		image.create( 16U, 16U, sf::Color::Red );
+		m_textures[1].loadFromImage( image );
+
+		m_hasFont = !s_params.fontFile.empty() && m_font.loadFromFile( s_params.fontFile );
+	}
+
+	void Update( const float deltaTime ) final
+	{
+		// Runs once on the first update, the engine exits after the state is removed as there is no window
+		if( !m_target.create( TargetSize.x, TargetSize.y ) )
+		{
+			LOG_CRIT( "Failed to create the benchmark render texture" );
+			RequestRemoveState();
+			return;
+		}
+
+		m_target.setView( sf::View( sf::FloatRect( 0.0f, 0.0f, ( float )TargetSize.x, ( float )TargetSize.y ) ) );
+
+		std::cout << "Render Benchmark (" << s_params.objectCount << " objects, " << s_params.frameCount << " frames, " << TargetSize.x << "x" << TargetSize.y << ")\n\n";
+		std::cout << std::setiosflags( std::ios::left ) << std::setw( 32 ) << "Scenario" << std::resetiosflags( std::ios::left )
+			<< std::setw( 12 ) << "Draw calls" << std::setw( 12 ) << "Vertices" << std::setw( 12 ) << "Avg ms" << std::setw( 12 ) << "Min ms" << std::setw( 12 ) << "Max ms" << "\n";
+
+		RunScenario( "Circles", [this]( const Object& object, const unsigned i )
+		{
+			object.AddComponent< Components::CircleShape >( 5.0f, 16U, RandomColour() );
+		} );
+
+		RunScenario( "Sprites (1 texture)", [this]( const Object& object, const unsigned i )
+		{
+			object.AddComponent< Components::Sprite >( m_textures[0] );
+		} );
+
+		RunScenario( "Sprites (2 textures interleaved)", [this]( const Object& object, const unsigned i )
+		{
+			object.AddComponent< Components::Sprite >( m_textures[i % 2] );
+		} );
+
+		if( m_hasFont )
+		{
+			RunScenario( "Text", [this]( const Object& object, const unsigned i )
+			{
+				object.AddComponent< Components::Text >( "Reflex", m_font, 12U );
+			} );
+		}
+		else
+		{
+			std::cout << "Text scenario skipped (pass a font file as the third argument)\n";
+		}
+
+		RunScenario( "Mixed", [this]( const Object& object, const unsigned i )
+		{
+			if( i % 3 == 0 )
+				object.AddComponent< Components::CircleShape >( 5.0f, 16U, RandomColour() );
+			else if( i % 3 == 1 || !m_hasFont )
+				object.AddComponent< Components::Sprite >( m_textures[0] );
+			else
+				object.AddComponent< Components::Text >( "Reflex", m_font, 12U );
+		} );
+
+		RequestRemoveState();
+	}
+
+protected:
+	template< typename Func >
+	void RunScenario( const std::string& name, Func addComponents )
+	{
+		auto& world = GetWorld();
+
+		const auto objects = world.CreateObjects( s_params.objectCount, [&]( const Object& object, const std::size_t i )
+		{
+			object.GetTransform()->setPosition( RandomFloat( ( float )TargetSize.x ), RandomFloat( ( float )TargetSize.y ) );
+			addComponents( object, ( unsigned )i );
+		} );
+
+		// Nothing moves during the benchmark, so transforms only need refreshing once
+		world.UpdateWorldTransforms();
+
+		const auto* renderSystem = world.GetSystem< Systems::RenderSystem >();
+		sf::Int64 totalTime = 0;
+		sf::Int64 minTime = std::numeric_limits< sf::Int64 >::max();
+		sf::Int64 maxTime = 0;
+
+		for( unsigned frame = 0U; frame < s_params.warmupFrames + s_params.frameCount; ++frame )
+		{
+			sf::Clock clock;
+			m_target.clear( sf::Color::Black );
+			m_target.draw( *renderSystem );
+			m_target.display();
+			const auto elapsed = clock.getElapsedTime().asMicroseconds();
+
+			if( frame < s_params.warmupFrames )
+				continue;
+
+			totalTime += elapsed;
+			minTime = std::min( minTime, elapsed );
+			maxTime = std::max( maxTime, elapsed );
+		}
+
+		const auto& stats = renderSystem->GetLastFrameStats();
+
+		std::cout << std::setprecision( 3 ) << std::fixed << std::setiosflags( std::ios::left ) << std::setw( 32 ) << name << std::resetiosflags( std::ios::left )
+			<< std::setw( 12 ) << stats.drawCalls << std::setw( 12 ) << stats.vertices
+			<< std::setw( 12 ) << ( totalTime / ( double )s_params.frameCount ) / 1000.0
+			<< std::setw( 12 ) << minTime / 1000.0 << std::setw( 12 ) << maxTime / 1000.0 << "\n";
+
+		// Not DestroyAllObjects, the scene root has to survive for the next scenario
+		world.DestroyObjects( objects );
+	}
+
+	sf::Color RandomColour() const
+	{
+		return sf::Color( ( sf::Uint8 )RandomInt( 255 ), ( sf::Uint8 )RandomInt( 255 ), ( sf::Uint8 )RandomInt( 255 ) );
+	}
+
+protected:
+	sf::RenderTexture m_target;
+	sf::Texture m_textures[2];
+	sf::Font m_font;
+	bool m_hasFont = false;
+};
+
+int main( int argc, char** argv )
+{
+	if( argc > 1 )
+		s_params.objectCount = ( unsigned )std::max( 1, std::atoi( argv[1] ) );
+	if( argc > 2 )
+		s_params.frameCount = ( unsigned )std::max( 1, std::atoi( argv[2] ) );
+	if( argc > 3 )
+		s_params.fontFile = argv[3];
+
+	Core::Engine engine( false );
+	engine.RegisterState< BenchmarkState >( true );
+	engine.Run();
+
+	return 0;
+}
@@ -35,18 +35,92 @@ public:
 		//test.AddComponent< Reflex::Components::Camera >();
 		//CreateROFile( "test", test );
 
+		RegisterSection( "---- Reflex Prefabs -------" );
+		RegisterTest( std::bind( &TestState::TestPrefabCompile, this ), true, "Test an object file is cached once loaded and its compiled .rob form creates the same object" );
+		RegisterTest( std::bind( &TestState::TestPrefabFields, this ), true, "Test a component's reflected fields (member and property fields) are saved to an object file and restored from it" );
+		RegisterTest( std::bind( &TestState::TestWorldSnapshot, this ), true, "Test loading a world snapshot restores objects at the same handles, with their components, parents and world positions" );
+		RegisterTest( std::bind( &TestState::TestWorldSnapshotTruncated, this ), true, "Test loading a snapshot truncated inside its component values throws and leaves the world untouched" );
+
 		RegisterSection( "---- Reflex Event System -------" );
 		RegisterTest( std::bind( &TestState::TestEventGeneric, this ), true, "Testing Subscribe / Emit with a generic event by transfering an int value through an event" );
 		RegisterTest( std::bind( &TestState::TestEventSpecific, this ), true, "Testing Subscribe / Emit on a specific target object (test we get the callback from the target" );
 		RegisterTest( std::bind( &TestState::TestEventSpecific2, this ), true, "Testing Subscribe / Emit on a specific target object (ensure we don't get callbacks from other objects)" );
 		RegisterTest( std::bind( &TestState::TestEventScopeSafety, this ), true, "Test automatic unsubscribing" );
 		RegisterTest( std::bind( &TestState::TestEventsMulti, this ), true, "Test multiple subscribing (different objects)" );
+		RegisterTest( std::bind( &TestState::TestEventTriggererReuse, this ), true, "Test a destroyed triggerer's recycled index doesn't deliver to receivers of the old triggerer, and unsubscribing one triggerer keeps the others" );
+		RegisterTest( std::bind( &TestState::TestEventQueue, this ), true, "Test queued events are only delivered on Flush, to both targeted and batch receivers" );
 		RegisterTest( std::bind( &TestState::TestEventsRenderSystem, this ), true, "Test the first real usage of the event system (Render System updating object render index when it changes)" );
 
+		RegisterSection( "---- Reflex Component Storage -------" );
+		RegisterTest( std::bind( &TestState::TestPackedComponentStorage, this ), true, "Test packed component storage keeps components valid after a removal (swap and pop) and iterates only live components" );
+		RegisterTest( std::bind( &TestState::TestComponentView, this ), true, "Test World::GetView only visits objects that have every viewed component" );
+
+		RegisterSection( "---- Reflex Job System -------" );
+		RegisterTest( std::bind( &TestState::TestJobSystemParallelFor, this ), true, "Test JobSystem::ParallelFor visits every index exactly once, including a nested ParallelFor inside a job" );
+		RegisterTest( std::bind( &TestState::TestJobSystemException, this ), true, "Test an exception thrown by a job is rethrown from RunAndWait after every other job has still run" );
+
+		RegisterSection( "---- Reflex TileMap -------" );
+		RegisterTest( std::bind( &TestState::TestTileMapChunks, this ), true, "Test TileMap range queries across chunk boundaries (including negative positions) and after the only object in a chunk is removed" );
+		RegisterTest( std::bind( &TestState::TestTileMapDeferredMoves, this ), true, "Test TileMap deferred moves only update the object's cell once the deferral ends" );
+		RegisterTest( std::bind( &TestState::TestLooseQuadTree, this ), true, "Test a LooseQuadTree spatial index returns a bounded object exactly once from bounds and view queries, including after it moves" );
+
+		RegisterSection( "---- Reflex Scene Graph -------" );
+		RegisterTest( std::bind( &TestState::TestCachedWorldTransforms, this ), true, "Test cached world transforms update when an ancestor moves, both lazily and through World::UpdateWorldTransforms" );
+		RegisterTest( std::bind( &TestState::TestTransformHierarchyReparent, this ), true, "Test reparenting under a newer object and destroying a parent keep the transform hierarchy's parents, children and world positions correct" );
+
+		RegisterSection( "---- Reflex Rendering -------" );
+		RegisterTest( std::bind( &TestState::TestRenderOrder, this ), true, "Test the render system's lazily sorted render order matches the objects' render indices after many z order changes and a removal" );
+		RegisterTest( std::bind( &TestState::TestRenderBatch, this ), true, "Test RenderBatch merges consecutive vertices with the same texture into one draw call and splits on texture changes or individual draws" );
+
+		RegisterSection( "---- Reflex System Pipeline -------" );
+		RegisterTest( std::bind( &TestState::TestSystemMembership, this ), true, "Test systems add an object once and removing one (swap and pop) keeps the remaining objects tracked" );
+		RegisterTest( std::bind( &TestState::TestBulkCreateDestroy, this ), true, "Test CreateObjects adds the batch (and objects created while initialising it) to systems once, and DestroyObjects removes them" );
+		RegisterTest( std::bind( &TestState::TestSystemStageOrder, this ), true, "Test systems update by stage then order, regardless of the order they were added" );
+
+		RegisterSection( "---- Reflex Steering -------" );
+		RegisterTest( std::bind( &TestState::TestFlockingKernel, this ), true, "Test the flocking kernel's sums match the scalar kernel within rounding, including stationary neighbours and a count that doesn't fill a SIMD register" );
+		RegisterTest( std::bind( &TestState::TestSteeringNeighbourCache, this ), true, "Test a cached neighbour list keeps the nearest capped neighbours and is only rebuilt once the boid moves more than half its skin" );
+		RegisterTest( std::bind( &TestState::TestSteeringWanderRandom, this ), true, "Test wandering boids calculated across the workers each pick a different heading" );
+
+		RegisterSection( "---- Reflex Physics -------" );
+		RegisterTest( std::bind( &TestState::TestPhysicsContacts, this ), true, "Test overlapping rigid bodies report begin and pre-solve contacts for the step they touch, with both objects and a normal" );
+		RegisterTest( std::bind( &TestState::TestPhysicsSleepingSync, this ), true, "Test the physics sync moves transforms of awake bodies to their body and leaves sleeping bodies' transforms alone" );
+		RegisterTest( std::bind( &TestState::TestRayCastQueries, this ), true, "Test closest hit ray casts return the nearest body by hit fraction, and any / all hit and batched ray casts agree with it" );
+
 		Run();
 	}
 
 protected:
+	class PackedTestComponent : public Reflex::Components::Component< PackedTestComponent >
+	{
+	public:
+		PackedTestComponent( const Reflex::Object& owner, const int value = 0 ) : Component< PackedTestComponent >( owner ), value( value ) { }
+		static std::string GetComponentName() { return "PackedTestComponent"; }
+
+		int value = 0;
+	};
+
+	class MembershipTestSystem : public Reflex::Systems::System
+	{
+	public:
+		using System::System;
+
+		void RegisterComponents() final { RequiresComponent( PackedTestComponent ); }
+		bool Contains( const Reflex::Object& object ) const { return HasObject( object ); }
+	};
+
+	template< int Id >
+	class OrderTestSystem : public Reflex::Systems::System
+	{
+	public:
+		OrderTestSystem( Reflex::Core::World& world, std::vector< int >& updates ) : System( world ), updates( updates ) { }
+
+		void RegisterComponents() final { }
+		void Update( const float deltaTime ) final { updates.push_back( Id ); }
+
+		std::vector< int >& updates;
+	};
+
 	struct TestEvent{ int test = 0; };
 	struct TestEvent2{ int test = 0; };
 
@@ -70,6 +144,111 @@ protected:
 		int value = 0;
 	};
 
+	bool TestPrefabCompile()
+	{
+		auto source = GetWorld().CreateObject( sf::Vector2f( 12.0f, 34.0f ), 45.0f );
+		GetWorld().CreateROFile( "PrefabTest", source );
+
+		const auto& prefab = GetWorld().GetPrefab( "PrefabTest.ro" );
+		const auto cached = &prefab == &GetWorld().GetPrefab( "PrefabTest.ro" );
+
+		GetWorld().CompilePrefab( "PrefabTest.ro", "PrefabTest.rob" );
+		auto compiled = GetWorld().CreateObject( "PrefabTest.rob" );
+
+		const auto matches = compiled.GetTransform()->getPosition() == sf::Vector2f( 12.0f, 34.0f ) && compiled.GetTransform()->getRotation() == 45.0f;
+
+		source.Destroy();
+		compiled.Destroy();
+		GetWorld().ClearPrefabCache();
+		std::remove( "PrefabTest.ro" );
+		std::remove( "PrefabTest.rob" );
+
+		return cached && matches;
+	}
+
+	bool TestPrefabFields()
+	{
+		auto source = GetWorld().CreateObject( sf::Vector2f( 5.0f, -5.0f ) );
+		source.AddComponent< Reflex::Components::CircleShape >( 7.0f, 12, sf::Color::Red );
+		source.AddComponent< Reflex::Components::Interactable >()->unselectIfLostFocus = true;
+		GetWorld().CreateROFile( "PrefabFieldsTest", source );
+
+		auto loaded = GetWorld().CreateObject( "PrefabFieldsTest.ro" );
+		const auto circle = loaded.GetComponent< Reflex::Components::CircleShape >();
+		const auto interactable = loaded.GetComponent< Reflex::Components::Interactable >();
+
+		const auto matches = circle && circle->getRadius() == 7.0f && circle->getPointCount() == 12 && circle->getFillColor() == sf::Color::Red
+			&& interactable && interactable->unselectIfLostFocus
+			&& loaded.GetTransform()->getPosition() == sf::Vector2f( 5.0f, -5.0f );
+
+		source.Destroy();
+		loaded.Destroy();
+		GetWorld().ClearPrefabCache();
+		std::remove( "PrefabFieldsTest.ro" );
+
+		return matches;
+	}
+
+	bool TestWorldSnapshot()
+	{
+		auto parent = GetWorld().CreateObject( sf::Vector2f( 10.0f, 20.0f ) );
+		auto child = GetWorld().CreateObject( sf::Vector2f( 5.0f, 0.0f ) );
+		parent.GetTransform()->AttachChild( child );
+		child.AddComponent< Reflex::Components::CircleShape >( 3.0f );
+
+		auto deleted = GetWorld().CreateObject();
+		deleted.Destroy();
+
+		GetWorld().SaveSnapshot( "SnapshotTest.rws" );
+		GetWorld().LoadSnapshot( "SnapshotTest.rws" );
+		std::remove( "SnapshotTest.rws" );
+
+		const auto circle = child.GetComponent< Reflex::Components::CircleShape >();
+
+		const auto restored = parent.IsValid() && child.IsValid() && !deleted.IsValid()
+			&& child.GetTransform()->GetParent() == parent
+			&& child.GetTransform()->GetWorldPosition() == sf::Vector2f( 15.0f, 20.0f )
+			&& circle && circle->getRadius() == 3.0f
+			&& GetWorld().GetSceneRoot().IsValid() && parent.GetTransform()->GetParent() == GetWorld().GetSceneRoot().object;
+
+		child.Destroy();
+		parent.Destroy();
+		return restored;
+	}
+
+	bool TestWorldSnapshotTruncated()
+	{
+		auto object = GetWorld().CreateObject( sf::Vector2f( 10.0f, 20.0f ) );
+		object.AddComponent< Reflex::Components::CircleShape >( 3.0f );
+		GetWorld().SaveSnapshot( "SnapshotTest.rws" );
+
+		std::string data;
+		{
+			std::ifstream input( "SnapshotTest.rws", std::ios::binary );
+			data.assign( std::istreambuf_iterator< char >( input ), std::istreambuf_iterator< char >() );
+		}
+
+		// Cuts off the end of the last component family's values
+		std::ofstream( "SnapshotTest.rws", std::ios::binary ).write( data.data(), data.size() - 4 );
+
+		bool threw = false;
+		try
+		{
+			GetWorld().LoadSnapshot( "SnapshotTest.rws" );
+		}
+		catch( const std::runtime_error& )
+		{
+			threw = true;
+		}
+
+		std::remove( "SnapshotTest.rws" );
+
+		const auto circle = object.GetComponent< Reflex::Components::CircleShape >();
+		const auto untouched = threw && object.IsValid() && circle && circle->getRadius() == 3.0f;
+		object.Destroy();
+		return untouched;
+	}
+
 	bool TestEventGeneric()
 	{
 		SpecificEventTriggerer triggerer( GetWorld() );
@@ -135,6 +314,76 @@ protected:
 		return value1 == 4444 && receiver.value == 234234;
 	}
 
+	bool TestEventTriggererReuse()
+	{
+		auto& events = GetWorld().GetEventManager();
+		SpecificEventReceiver receiver;
+		SpecificEventReceiver receiver2;
+		SpecificEventTriggerer triggerer2( GetWorld() );
+
+		{
+			SpecificEventTriggerer triggerer( GetWorld() );
+			events.Subscribe< TestEvent >( triggerer, receiver, &SpecificEventReceiver::OnTestEvent );
+		}
+
+		// Takes the destroyed triggerer's index
+		SpecificEventTriggerer triggerer3( GetWorld() );
+		events.Subscribe< TestEvent >( triggerer3, receiver2, &SpecificEventReceiver::OnTestEvent );
+		triggerer3.Emit( events, 10 );
+		const auto reuseCorrect = receiver.value == 0 && receiver2.value == 10;
+
+		events.Subscribe< TestEvent >( triggerer2, receiver2, &SpecificEventReceiver::OnTestEvent );
+		events.Unsubscribe( triggerer3, receiver2 );
+		triggerer3.Emit( events, 20 );
+		triggerer2.Emit( events, 30 );
+
+		return reuseCorrect && receiver2.value == 30;
+	}
+
+	struct BatchEventReceiver : public Reflex::Core::EventReceiver
+	{
+		void OnTestEvents( const std::vector< TestEvent >& events )
+		{
+			for( const auto& e : events )
+				total += e.test;
+			++batches;
+		}
+
+		int total = 0;
+		int batches = 0;
+	};
+
+	struct QueueingEventTriggerer : public Reflex::Core::EventTriggerer
+	{
+		using Reflex::Core::EventTriggerer::EventTriggerer;
+
+		void Queue( const int value )
+		{
+			EventTriggerer::Queue( TestEvent{ value } );
+		}
+	};
+
+	bool TestEventQueue()
+	{
+		auto& events = GetWorld().GetEventManager();
+		QueueingEventTriggerer triggerer( GetWorld() );
+		SpecificEventReceiver receiver;
+		BatchEventReceiver batchReceiver;
+
+		events.Subscribe< TestEvent >( triggerer, receiver, &SpecificEventReceiver::OnTestEvent );
+		events.SubscribeBatch< TestEvent >( batchReceiver, &BatchEventReceiver::OnTestEvents );
+
+		triggerer.Queue( 1 );
+		triggerer.Queue( 2 );
+		triggerer.Queue( 3 );
+		const auto nothingDelivered = receiver.value == 0 && batchReceiver.batches == 0;
+
+		events.Flush();
+		events.Flush();
+
+		return nothingDelivered && receiver.value == 3 && batchReceiver.batches == 1 && batchReceiver.total == 6;
+	}
+
 	bool TestEventsRenderSystem()
 	{
 		auto object = GetWorld().CreateObject();
@@ -145,10 +394,530 @@ protected:
 
 		const auto* render = GetWorld().GetSystem< Reflex::Systems::RenderSystem >();
 
-		const auto startOrdering = render->GetObjects()[0] == object && render->GetObjects()[1] == object2;
+		const auto startOrdering = render->GetRenderOrder()[0] == object && render->GetRenderOrder()[1] == object2;
 		object.GetTransform()->SetZOrder( 100 );
-		const auto newOrdering = render->GetObjects()[0] == object2 && render->GetObjects()[1] == object;
+		GetWorld().GetEventManager().Flush();
+		const auto newOrdering = render->GetRenderOrder()[0] == object2 && render->GetRenderOrder()[1] == object;
 
 		return startOrdering && newOrdering;
 	}
+
+	bool TestPackedComponentStorage()
+	{
+		GetWorld().RegisterComponent< PackedTestComponent >( Reflex::Core::ComponentStorage::Packed );
+
+		auto object = GetWorld().CreateObject();
+		object.AddComponent< PackedTestComponent >( 1 );
+		auto object2 = GetWorld().CreateObject();
+		object2.AddComponent< PackedTestComponent >( 2 );
+		auto object3 = GetWorld().CreateObject();
+		object3.AddComponent< PackedTestComponent >( 3 );
+
+		// Removing the first component relocates the last one into its slot
+		object.RemoveComponent< PackedTestComponent >();
+
+		unsigned count = 0;
+		int total = 0;
+		GetWorld().ForEachComponent< PackedTestComponent >( [&]( const PackedTestComponent& component )
+		{
+			++count;
+			total += component.value;
+		} );
+
+		return count == 2 && total == 5 && !object.HasComponent< PackedTestComponent >() &&
+			object2.GetComponent< PackedTestComponent >()->value == 2 &&
+			object3.GetComponent< PackedTestComponent >()->value == 3 &&
+			object3.GetComponent< PackedTestComponent >()->GetObject() == object3;
+	}
+
+	bool TestComponentView()
+	{
+		const auto countView = [&]()
+		{
+			unsigned count = 0;
+			GetWorld().GetView< Reflex::Components::Transform, PackedTestComponent >().ForEach( [&]( Reflex::Components::Transform& transform, PackedTestComponent& component )
+			{
+				if( component.GetTransform().Get() == &transform )
+					++count;
+			} );
+			return count;
+		};
+
+		const auto startCount = countView();
+
+		auto object = GetWorld().CreateObject();
+		object.AddComponent< PackedTestComponent >( 10 );
+		GetWorld().CreateObject();
+
+		return countView() == startCount + 1;
+	}
+
+	bool TestTileMapChunks()
+	{
+		// Default tile map is 200 unit cells in 20x20 cell chunks, so these straddle chunk boundaries on both sides of zero
+		const auto countInRange = [&]( const sf::Vector2f& position, const Reflex::Object& target )
+		{
+			unsigned count = 0;
+			GetWorld().GetSpatialIndex().ForEachInRange( position, 50.0f, [&]( const Reflex::Object& object )
+			{
+				if( object == target )
+					++count;
+			} );
+			return count;
+		};
+
+		auto negative = GetWorld().CreateObject( sf::Vector2f( -4010.0f, -10.0f ) );
+		auto positive = GetWorld().CreateObject( sf::Vector2f( 4010.0f, 10.0f ) );
+
+		const bool found = countInRange( sf::Vector2f( -3990.0f, 0.0f ), negative ) == 1 && countInRange( sf::Vector2f( 3990.0f, 0.0f ), positive ) == 1;
+
+		negative.Destroy();
+		const bool removed = countInRange( sf::Vector2f( -3990.0f, 0.0f ), negative ) == 0;
+
+		positive.Destroy();
+		return found && removed;
+	}
+
+	bool TestTileMapDeferredMoves()
+	{
+		const auto isNear = [&]( const sf::Vector2f& position, const Reflex::Object& target )
+		{
+			bool found = false;
+			GetWorld().GetSpatialIndex().ForEachInRange( position, 50.0f, [&]( const Reflex::Object& object ) { found |= object == target; } );
+			return found;
+		};
+
+		auto& spatialIndex = GetWorld().GetSpatialIndex();
+		auto object = GetWorld().CreateObject( sf::Vector2f( 100.0f, 100.0f ) );
+
+		spatialIndex.BeginDeferredMoves();
+		object.GetTransform()->setPosition( sf::Vector2f( 900.0f, 100.0f ) );
+		const bool beforeFlush = !isNear( sf::Vector2f( 900.0f, 100.0f ), object );
+		spatialIndex.EndDeferredMoves( GetWorld().GetJobSystem() );
+		const bool afterFlush = !isNear( sf::Vector2f( 100.0f, 100.0f ), object ) && isNear( sf::Vector2f( 900.0f, 100.0f ), object );
+
+		object.Destroy();
+		return beforeFlush && afterFlush;
+	}
+
+	bool TestLooseQuadTree()
+	{
+		GetWorld().SetSpatialIndex< Reflex::Core::LooseQuadTree >( GetWorld().GetBounds(), 6U );
+
+		const auto countInBounds = [&]( const sf::FloatRect& bounds, const Reflex::Object& target )
+		{
+			unsigned count = 0;
+			GetWorld().GetSpatialIndex().ForEachInBounds( bounds, [&]( const Reflex::Object& object )
+			{
+				if( object == target )
+					++count;
+			} );
+			return count;
+		};
+
+		// Large enough to span several nodes on the deeper levels
+		auto object = GetWorld().CreateObject( sf::Vector2f( 300.0f, 300.0f ) );
+		object.GetTransform()->SetLocalBounds( Reflex::BoundingBox( sf::FloatRect( -100.0f, -100.0f, 200.0f, 200.0f ) ) );
+
+		const bool found = countInBounds( sf::FloatRect( 380.0f, 380.0f, 10.0f, 10.0f ), object ) == 1 && countInBounds( sf::FloatRect( 500.0f, 500.0f, 10.0f, 10.0f ), object ) == 0;
+
+		unsigned viewCount = 0;
+		GetWorld().GetSpatialIndex().ForEachInView( sf::View( sf::Vector2f( 300.0f, 300.0f ), sf::Vector2f( 100.0f, 100.0f ) ), [&]( const Reflex::Object& other )
+		{
+			if( other == object )
+				++viewCount;
+		} );
+
+		object.GetTransform()->setPosition( sf::Vector2f( 900.0f, 300.0f ) );
+		const bool moved = countInBounds( sf::FloatRect( 380.0f, 380.0f, 10.0f, 10.0f ), object ) == 0 && countInBounds( sf::FloatRect( 980.0f, 380.0f, 10.0f, 10.0f ), object ) == 1;
+
+		object.Destroy();
+		GetWorld().SetSpatialIndex< Reflex::Core::TileMap >( 200U, 20U );
+		return found && viewCount == 1 && moved;
+	}
+
+	bool TestCachedWorldTransforms()
+	{
+		auto parent = GetWorld().CreateObject( sf::Vector2f( 100.0f, 0.0f ) );
+		auto child = GetWorld().CreateObject( sf::Vector2f( 10.0f, 0.0f ), 0.0f, sf::Vector2f( 1.0f, 1.0f ), false );
+		auto grandChild = GetWorld().CreateObject( sf::Vector2f( 1.0f, 0.0f ), 0.0f, sf::Vector2f( 1.0f, 1.0f ), false );
+		parent.GetTransform()->AttachChild( child );
+		child.GetTransform()->AttachChild( grandChild );
+
+		const bool attached = grandChild.GetTransform()->GetWorldPosition() == sf::Vector2f( 111.0f, 0.0f );
+
+		// Lazily refreshed on get
+		parent.GetTransform()->setPosition( sf::Vector2f( 200.0f, 0.0f ) );
+		const bool lazy = grandChild.GetTransform()->GetWorldPosition() == sf::Vector2f( 211.0f, 0.0f );
+
+		// Refreshed by the hierarchy pass, including scale
+		parent.GetTransform()->setScale( 2.0f, 2.0f );
+		GetWorld().UpdateWorldTransforms();
+		const bool updated = grandChild.GetTransform()->GetWorldPosition() == sf::Vector2f( 222.0f, 0.0f ) && grandChild.GetTransform()->GetWorldScale() == sf::Vector2f( 2.0f, 2.0f );
+
+		grandChild.Destroy();
+		child.Destroy();
+		parent.Destroy();
+		return attached && lazy && updated;
+	}
+
+	bool TestTransformHierarchyReparent()
+	{
+		auto child = GetWorld().CreateObject( sf::Vector2f( 5.0f, 0.0f ) );
+		auto grandChild = GetWorld().CreateObject( sf::Vector2f( 1.0f, 0.0f ), 0.0f, sf::Vector2f( 1.0f, 1.0f ), false );
+		child.GetTransform()->AttachChild( grandChild );
+
+		// The parent is created after the child, so attaching has to move the child's subtree after it
+		auto parent = GetWorld().CreateObject( sf::Vector2f( 100.0f, 0.0f ) );
+		parent.GetTransform()->AttachChild( child );
+		GetWorld().UpdateWorldTransforms();
+
+		const bool attached = child.GetTransform()->GetParent() == parent && parent.GetTransform()->GetChildrenCount() == 1U &&
+			grandChild.GetTransform()->GetWorldPosition() == sf::Vector2f( 106.0f, 0.0f );
+
+		// Children of a destroyed object become roots
+		parent.Destroy();
+		GetWorld().UpdateWorldTransforms();
+
+		const bool removed = !child.GetTransform()->GetParent().IsValid() && child.GetTransform()->GetChildrenCount() == 1U &&
+			grandChild.GetTransform()->GetWorldPosition() == sf::Vector2f( 6.0f, 0.0f );
+
+		grandChild.Destroy();
+		child.Destroy();
+		return attached && removed;
+	}
+
+	bool TestRenderOrder()
+	{
+		std::vector< Reflex::Object > objects;
+		for( unsigned i = 0; i < 300; ++i )
+		{
+			objects.push_back( GetWorld().CreateObject() );
+			objects.back().AddComponent< Reflex::Components::CircleShape >( 5.0f );
+			objects.back().GetTransform()->SetZOrder( Reflex::RandomInt( 5000 ) );
+		}
+
+		objects[10].Destroy();
+		GetWorld().GetEventManager().Flush();
+
+		const auto* render = GetWorld().GetSystem< Reflex::Systems::RenderSystem >();
+		const auto& order = render->GetRenderOrder();
+
+		const auto sorted = std::is_sorted( order.begin(), order.end(), []( const Reflex::Object& left, const Reflex::Object& right )
+		{
+			return left.GetTransform()->GetRenderIndex() < right.GetTransform()->GetRenderIndex();
+		} );
+
+		const auto size = order.size() == render->GetObjects().size();
+		const auto removed = !Reflex::Contains( order, objects[10] );
+
+		for( auto& object : objects )
+			if( object.IsValid() )
+				object.Destroy();
+
+		return sorted && size && removed;
+	}
+
+	bool TestRenderBatch()
+	{
+		sf::RenderTexture target;
+		sf::Texture texture;
+		if( !target.create( 16, 16 ) || !texture.create( 4, 4 ) )
+			return false;
+
+		sf::VertexArray vertices;
+		Reflex::Core::RenderBatch batch( target, sf::RenderStates(), vertices );
+
+		// Two untextured quads share a draw call, the textured one and the individual draw each need their own
+		batch.Allocate( nullptr, 6 );
+		batch.Allocate( nullptr, 6 );
+		batch.Allocate( &texture, 6 );
+		batch.BeginIndividualDraw();
+		batch.Allocate( &texture, 6 );
+		batch.Flush();
+
+		return batch.GetDrawCalls() == 4U && batch.GetVertexCount() == 24U;
+	}
+
+	bool TestSystemMembership()
+	{
+		auto* system = GetWorld().AddSystem< MembershipTestSystem >();
+
+		std::vector< Reflex::Object > objects;
+		for( int i = 0; i < 4; ++i )
+		{
+			objects.push_back( GetWorld().CreateObject() );
+			objects.back().AddComponent< PackedTestComponent >( i );
+		}
+
+		// Adding a second component doesn't add the object again
+		objects[0].AddComponent< Reflex::Components::CircleShape >( 5.0f );
+		const auto addedOnce = system->GetObjects().size() == 4U;
+
+		objects[1].RemoveComponent< PackedTestComponent >();
+		const auto removed = system->GetObjects().size() == 3U && !system->Contains( objects[1] );
+		const auto kept = system->Contains( objects[0] ) && system->Contains( objects[2] ) && system->Contains( objects[3] );
+
+		for( auto& object : objects )
+			object.Destroy();
+
+		const auto empty = system->GetObjects().empty();
+		GetWorld().RemoveSystem< MembershipTestSystem >();
+
+		return addedOnce && removed && kept && empty;
+	}
+
+	bool TestBulkCreateDestroy()
+	{
+		auto* system = GetWorld().AddSystem< MembershipTestSystem >();
+		std::vector< Reflex::Object > extras;
+
+		auto objects = GetWorld().CreateObjects( 100, [&]( const Reflex::Object& object, const std::size_t i )
+		{
+			object.AddComponent< PackedTestComponent >( ( int )i );
+			object.AddComponent< Reflex::Components::CircleShape >( 5.0f );
+
+			if( i % 50 == 0 )
+			{
+				extras.push_back( GetWorld().CreateObject() );
+				extras.back().AddComponent< PackedTestComponent >();
+			}
+		} );
+
+		const auto* render = GetWorld().GetSystem< Reflex::Systems::RenderSystem >();
+		const auto created = system->GetObjects().size() == 102U && std::all_of( objects.begin(), objects.end(), [&]( const Reflex::Object& object )
+		{
+			return system->Contains( object ) && render->GetRenderOrder().end() != std::find( render->GetRenderOrder().begin(), render->GetRenderOrder().end(), object );
+		} );
+
+		objects.insert( objects.end(), extras.begin(), extras.end() );
+		GetWorld().DestroyObjects( objects );
+
+		const auto destroyed = system->GetObjects().empty() && std::none_of( objects.begin(), objects.end(), []( const Reflex::Object& object ) { return object.IsValid(); } );
+		GetWorld().RemoveSystem< MembershipTestSystem >();
+
+		return created && destroyed;
+	}
+
+	bool TestSystemStageOrder()
+	{
+		std::vector< int > updates;
+		GetWorld().AddSystemToStage< OrderTestSystem< 3 > >( Reflex::Systems::SystemStage::RenderPrep, 0, updates );
+		GetWorld().AddSystemToStage< OrderTestSystem< 2 > >( Reflex::Systems::SystemStage::PostPhysics, 5, updates );
+		GetWorld().AddSystemToStage< OrderTestSystem< 1 > >( Reflex::Systems::SystemStage::PostPhysics, -5, updates );
+		GetWorld().Update( 0.0f );
+		GetWorld().RemoveSystem< OrderTestSystem< 1 > >();
+		GetWorld().RemoveSystem< OrderTestSystem< 2 > >();
+		GetWorld().RemoveSystem< OrderTestSystem< 3 > >();
+
+		return updates == std::vector< int >{ 1, 2, 3 };
+	}
+
+	bool TestFlockingKernel()
+	{
+		Reflex::Systems::FlockingNeighbours neighbours;
+		for( unsigned i = 0; i < 103; ++i )
+		{
+			const auto velocity = i % 10 == 0 ? sf::Vector2f() : sf::Vector2f( Reflex::RandomFloat( -100.0f, 100.0f ), Reflex::RandomFloat( -100.0f, 100.0f ) );
+			neighbours.Add( sf::Vector2f( Reflex::RandomFloat( -300.0f, 300.0f ), Reflex::RandomFloat( -300.0f, 300.0f ) ), velocity );
+		}
+
+		const auto position = sf::Vector2f( 1.0f, 2.0f );
+		const auto simd = Reflex::Systems::SumFlockingForces( neighbours, position );
+		const auto scalar = Reflex::Systems::SumFlockingForcesScalar( neighbours, position );
+
+		const auto close = []( const sf::Vector2f& a, const sf::Vector2f& b )
+		{
+			return Reflex::GetMagnitude( a - b ) <= 1e-4f * std::max( 1.0f, Reflex::GetMagnitude( b ) );
+		};
+
+		return close( simd.alignment, scalar.alignment ) && close( simd.cohesion, scalar.cohesion ) && close( simd.separation, scalar.separation );
+	}
+
+	bool TestSteeringNeighbourCache()
+	{
+		const auto createBoid = [&]( const sf::Vector2f& position )
+		{
+			auto object = GetWorld().CreateObject( position );
+			object.AddComponent< Reflex::Components::Steering >()->Flocking( 100.0f, 1.0f, 1.0f, 1.0f, 100.0f );
+			return object;
+		};
+
+		auto boid = createBoid( sf::Vector2f( 1000.0f, 1000.0f ) );
+		auto first = createBoid( sf::Vector2f( 1010.0f, 1000.0f ) );
+		auto second = createBoid( sf::Vector2f( 1020.0f, 1000.0f ) );
+
+		const auto steering = boid.GetComponent< Reflex::Components::Steering >();
+		steering->CacheNeighbours( 50.0f, 1U );
+
+		// No time passes so steering doesn't move the boids, only the test does
+		GetWorld().Update( 0.0f );
+		const auto nearest = steering->GetCachedNeighbours() == std::vector< Reflex::Object >{ first };
+
+		// Second is now nearer, but the boid hasn't moved so the list is kept
+		second.GetTransform()->setPosition( sf::Vector2f( 995.0f, 1000.0f ) );
+		GetWorld().Update( 0.0f );
+		const auto cached = steering->GetCachedNeighbours() == std::vector< Reflex::Object >{ first };
+
+		// Moving more than half the skin rebuilds it, second is now nearest (25 away, first is 40)
+		boid.GetTransform()->setPosition( sf::Vector2f( 970.0f, 1000.0f ) );
+		GetWorld().Update( 0.0f );
+		const auto rebuilt = steering->GetCachedNeighbours() == std::vector< Reflex::Object >{ second };
+
+		boid.Destroy();
+		first.Destroy();
+		second.Destroy();
+		return nearest && cached && rebuilt;
+	}
+
+	bool TestSteeringWanderRandom()
+	{
+		// Enough boids to be split across the workers, spaced out so only Wander affects them
+		std::vector< Reflex::Object > boids;
+		for( unsigned i = 0; i < 64; ++i )
+		{
+			auto object = GetWorld().CreateObject( sf::Vector2f( 1000.0f + i * 100.0f, 1000.0f ) );
+			object.AddComponent< Reflex::Components::Steering >()->Wander( 10.0f, 20.0f, 100.0f, 100.0f );
+			boids.push_back( object );
+		}
+
+		// Boids start stationary, so each picks its heading in Wander
+		GetWorld().Update( 1.0f / 60.0f );
+
+		std::vector< float > headings;
+		for( auto& boid : boids )
+		{
+			const auto velocity = boid.GetTransform()->GetVelocity();
+			headings.push_back( std::atan2( velocity.y, velocity.x ) );
+			boid.Destroy();
+		}
+
+		std::sort( headings.begin(), headings.end() );
+		return std::adjacent_find( headings.begin(), headings.end() ) == headings.end();
+	}
+
+	bool TestPhysicsContacts()
+	{
+		const auto createBody = [&]( const sf::Vector2f& position )
+		{
+			auto object = GetWorld().CreateObject( position );
+			object.AddComponent< Reflex::Components::RigidBody >( b2_dynamicBody );
+			object.AddComponent< Reflex::Components::CircleCollider >( 10.0f );
+			return object;
+		};
+
+		auto first = createBody( sf::Vector2f( 100.0f, 100.0f ) );
+		auto second = createBody( sf::Vector2f( 105.0f, 100.0f ) );
+
+		GetWorld().Update( 1.0f / 60.0f );
+
+		const auto touches = [&]( const Reflex::Core::Contact& contact, const Reflex::Core::ContactType type )
+		{
+			return contact.type == type && contact.pointCount > 0 && contact.normal != sf::Vector2f()
+				&& ( ( contact.GetObjectA() == first && contact.GetObjectB() == second ) || ( contact.GetObjectA() == second && contact.GetObjectB() == first ) );
+		};
+
+		const auto& contacts = GetWorld().GetContacts();
+		const auto found = std::any_of( contacts.begin(), contacts.end(), [&]( const auto& contact ) { return touches( contact, Reflex::Core::ContactType::Begin ); } )
+			&& std::any_of( contacts.begin(), contacts.end(), [&]( const auto& contact ) { return touches( contact, Reflex::Core::ContactType::PreSolve ); } );
+
+		first.Destroy();
+		second.Destroy();
+		return found;
+	}
+
+	bool TestPhysicsSleepingSync()
+	{
+		auto awake = GetWorld().CreateObject( sf::Vector2f( 100.0f, 100.0f ) );
+		const auto awakeBody = awake.AddComponent< Reflex::Components::RigidBody >( b2_dynamicBody );
+
+		auto sleeping = GetWorld().CreateObject( sf::Vector2f( 300.0f, 100.0f ) );
+		sleeping.AddComponent< Reflex::Components::RigidBody >( b2_dynamicBody )->GetBody().SetAwake( false );
+
+		// Only an awake body would overwrite this
+		sleeping.GetTransform()->setPosition( sf::Vector2f( 400.0f, 100.0f ) );
+
+		GetWorld().Update( 1.0f / 60.0f );
+
+		const auto synced = awake.GetTransform()->getPosition() == awakeBody->GetPosition() && awake.GetTransform()->getPosition().y > 100.0f
+			&& sleeping.GetTransform()->getPosition() == sf::Vector2f( 400.0f, 100.0f );
+
+		awake.Destroy();
+		sleeping.Destroy();
+		return synced;
+	}
+
+	bool TestRayCastQueries()
+	{
+		const auto createBody = [&]( const sf::Vector2f& position )
+		{
+			auto object = GetWorld().CreateObject( position );
+			object.AddComponent< Reflex::Components::RigidBody >( b2_staticBody );
+			object.AddComponent< Reflex::Components::CircleCollider >( 10.0f );
+			return object;
+		};
+
+		// Far is created first so Box2D doesn't happen to report the near body first
+		auto far = createBody( sf::Vector2f( 1300.0f, 1000.0f ) );
+		auto near = createBody( sf::Vector2f( 1100.0f, 1000.0f ) );
+
+		const auto from = sf::Vector2f( 1000.0f, 1000.0f );
+		const auto to = sf::Vector2f( 1400.0f, 1000.0f );
+		const auto closest = GetWorld().RayCast( from, to );
+
+		std::vector< Reflex::Core::World::RayCastResult > all;
+		GetWorld().RayCastAll( from, to, all );
+
+		const std::vector< Reflex::Core::World::Ray > rays = { { from, to }, { to, from }, { from, sf::Vector2f( 1000.0f, 1400.0f ) } };
+		std::vector< Reflex::Core::World::RayCastResult > batch;
+		GetWorld().RayCastBatch( rays, batch );
+
+		const auto result = closest && closest.GetObject() == near && std::abs( closest.point.x - 1090.0f ) < 0.01f && closest.normal == sf::Vector2f( -1.0f, 0.0f )
+			&& GetWorld().RayCastAny( from, to )
+			&& all.size() == 2U
+			&& batch.size() == 3U && batch[0].GetObject() == near && batch[1].GetObject() == far && !batch[2];
+
+		far.Destroy();
+		near.Destroy();
+		return result;
+	}
+
+	bool TestJobSystemException()
+	{
+		std::atomic< int > visits = 0;
+
+		try
+		{
+			GetWorld().GetJobSystem().ParallelFor( 1000, 10, [&]( const std::size_t begin, const std::size_t end )
+			{
+				visits += int( end - begin );
+				if( begin == 0 )
+					throw std::runtime_error( "Job failed" );
+			} );
+		}
+		catch( const std::runtime_error& )
+		{
+			return visits == 1000;
+		}
+
+		return false;
+	}
+
+	bool TestJobSystemParallelFor()
+	{
+		std::vector< std::atomic< int > > visits( 1000 );
+		auto& jobSystem = GetWorld().GetJobSystem();
+
+		jobSystem.ParallelFor( 10, 1, [&]( const std::size_t begin, const std::size_t end )
+		{
+			for( auto i = begin; i < end; ++i )
+				jobSystem.ParallelFor( 100, 8, [&]( const std::size_t innerBegin, const std::size_t innerEnd )
+				{
+					for( auto j = innerBegin; j < innerEnd; ++j )
+						++visits[i * 100 + j];
+				} );
+		} );
+
+		return std::all_of( visits.begin(), visits.end(), []( const std::atomic< int >& count ) { return count == 1; } );
+	}
 };